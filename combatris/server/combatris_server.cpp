@@ -0,0 +1,53 @@
+#include "server/relay.h"
+
+#include <csignal>
+#include <iostream>
+
+namespace {
+
+const size_t kDefaultMaxPlayers = 32;
+const int kDefaultProgressInterval = 100;
+
+std::atomic<bool> cancelled(false);
+
+void SignalHandler(int) { cancelled.store(true, std::memory_order_release); }
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  size_t max_players = kDefaultMaxPlayers;
+  int progress_interval = kDefaultProgressInterval;
+
+  try {
+    if (argc > 1) {
+      max_players = std::stoul(argv[1]);
+    }
+    if (argc > 2) {
+      progress_interval = std::stoi(argv[2]);
+    }
+  } catch (const std::exception&) {
+    std::cout << "Usage: " << argv[0] << " [max players (" << kDefaultMaxPlayers << ")] [progress interval in ms ("
+              << kDefaultProgressInterval << ")]" << std::endl;
+    return -1;
+  }
+  std::signal(SIGINT, SignalHandler);
+  std::signal(SIGTERM, SignalHandler);
+
+  if (!network::Startup()) {
+    return -1;
+  }
+  int ret_value = 0;
+  {
+    auto transport = std::make_unique<network::UDPRelayTransport>(network::GetPort());
+
+    if (transport->is_open()) {
+      std::cout << "Relay listening on port " << network::GetPort() << std::endl;
+      network::Relay(std::move(transport), max_players, progress_interval).Run(cancelled);
+    } else {
+      ret_value = -1;
+    }
+  }
+  network::Cleanup();
+
+  return ret_value;
+}
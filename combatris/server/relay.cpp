@@ -0,0 +1,266 @@
+#include "server/relay.h"
+
+#include <iostream>
+
+namespace network {
+
+namespace {
+
+const int kWaitForIncomingPackages = 10;
+
+} // namespace
+
+ssize_t UDPRelayTransport::Receive(void* buff, size_t max_size, sockaddr_in& from_addr, int max_wait_ms) {
+  const auto size = server_.Receive(buff, max_size, from_addr, max_wait_ms);
+
+  from_addr.sin_port = htons(static_cast<uint16_t>(port_));
+
+  return size;
+}
+
+Relay::Relay(std::unique_ptr<RelayTransport> transport, size_t max_players, int progress_interval)
+    : transport_(std::move(transport)), max_players_(max_players), progress_interval_(progress_interval) {}
+
+void Relay::FanOut(const char* buffer, size_t size) {
+  for (const auto& [host_id, subscriber] : subscribers_) {
+    if (subscriber.admitted_) {
+      transport_->Send(buffer, size, subscriber.address_);
+    }
+  }
+}
+
+// The refused player gets a leave in its own name, the host id is derived from the name
+void Relay::SendRefused(const Subscriber& subscriber, const Header& join_header) {
+  ReliablePackage package(subscriber.connection_.name(), 1);
+
+  package.package_.packages_[0] = CreatePackage(Request::Leave, GameState::Idle);
+  package.package_.packages_[0].header_.SetSeqenceNr(join_header.sequence_nr());
+  transport_->Send(&package, sizeof(package), subscriber.address_);
+}
+
+bool Relay::UpdateLobby(uint64_t host_id, Subscriber& subscriber, const Package& package) {
+  const auto& header = package.header_;
+  const auto& name = subscriber.connection_.name();
+
+  switch (header.request()) {
+    case Request::Join:
+      if (!subscriber.admitted_) {
+        auto players = std::count_if(subscribers_.begin(), subscribers_.end(), [](const auto& s) { return s.second.admitted_; });
+
+        if (static_cast<size_t>(players) >= max_players_) {
+          std::cout << name << " cannot join, the room is full (" << max_players_ << " players)" << std::endl;
+          SendRefused(subscriber, header);
+          return true;
+        }
+        std::cout << name << " joined" << std::endl;
+        subscriber.admitted_ = true;
+      }
+      subscriber.state_ = package.payload_.state();
+      break;
+    case Request::Leave:
+      std::cout << name << " left" << std::endl;
+      progress_updates_.erase(host_id);
+      return false;
+    case Request::NewGame:
+    case Request::StartGame:
+    case Request::NewState:
+      subscriber.state_ = (GameState::None == package.payload_.state()) ? subscriber.state_ : package.payload_.state();
+      break;
+    default:
+      return true;
+  }
+  PrintLobby();
+
+  return true;
+}
+
+void Relay::HandleReliableChannel(ssize_t size, const char* buffer, const sockaddr_in& from_addr) {
+  if (size != static_cast<ssize_t>(sizeof(ReliablePackage))) {
+    std::cout << "incomplete package - " << size << std::endl;
+    return;
+  }
+  const auto reliable_package = reinterpret_cast<const ReliablePackage*>(buffer);
+  const auto& package_header = reliable_package->header_;
+  const auto& package_array = reliable_package->package_;
+  const uint64_t host_id = package_header.host_id();
+
+  if (subscribers_.count(host_id) == 0) {
+    subscribers_.emplace(host_id, Subscriber(package_header.host_name(), package_array, from_addr));
+  }
+  auto& subscriber = subscribers_.at(host_id);
+  auto& connection = subscriber.connection_;
+
+  liveness_.Refresh(host_id);
+
+  auto package_index = connection.VerifySequenceNumber(Channel::Reliable, package_array.packages_[0].header_);
+
+  if (package_index < 0) {
+    return;
+  }
+  if (package_index > package_array.size() || package_index >= kWindowSize) {
+    std::cout << connection.name() << " has lost too many packages, connection will be terminated" << std::endl;
+    EraseSubscriber(host_id);
+    return;
+  }
+  bool keep_subscriber = true;
+
+  for (auto i = package_index; i >= 0; --i) {
+    const auto& package = package_array.packages_[i];
+
+    if (!package.header_.Verify()) {
+      continue;
+    }
+    connection.Update(Channel::Reliable, package.header_);
+    keep_subscriber = UpdateLobby(host_id, subscriber, package) && keep_subscriber;
+  }
+  if (subscriber.admitted_) {
+    FanOut(buffer, size);
+  }
+  if (!keep_subscriber) {
+    EraseSubscriber(host_id);
+    PrintLobby();
+  }
+}
+
+void Relay::HandleUnreliableChannel(ssize_t size, const char* buffer) {
+  const auto unreliable_package = reinterpret_cast<const UnreliablePackage*>(buffer);
+
+  if (size < static_cast<ssize_t>(sizeof(UnreliablePackage) - kMatrixStateSize) ||
+      size != static_cast<ssize_t>(unreliable_package->size()) ||
+      unreliable_package->package_.payload_.size() > kMatrixStateSize) {
+    std::cout << "UnreliableChannel - package - " << size << std::endl;
+    return;
+  }
+  const uint64_t host_id = unreliable_package->header_.host_id();
+
+  if (subscribers_.count(host_id) == 0 || !subscribers_.at(host_id).admitted_) {
+    return;
+  }
+  auto& connection = subscribers_.at(host_id).connection_;
+  const auto& header = unreliable_package->package_.header_;
+  const auto& payload = unreliable_package->package_.payload_;
+
+  liveness_.Refresh(host_id);
+  if (connection.VerifySequenceNumber(Channel::Unreliable, header) < 0) {
+    return;
+  }
+  connection.Update(Channel::Unreliable, header);
+
+  auto& progress_update = progress_updates_[host_id];
+
+  progress_update.latest_.assign(buffer, buffer + size);
+  progress_update.sequence_nr_ = header.sequence_nr();
+  progress_update.latest_key_frame_ = (MatrixEncoding::None == payload.encoding()) ? -1 : payload.key_frame();
+  if (MatrixEncoding::KeyFrame == payload.encoding()) {
+    progress_update.key_frame_package_ = progress_update.latest_;
+    progress_update.key_frame_ = payload.key_frame();
+  }
+}
+
+// A delta is useless without the key frame it's based on, so if the subscriber hasn't got the key frame (it has
+// been replaced before the subscriber was due for an update) it's sent before the delta.
+void Relay::SendProgressUpdates() {
+  const auto now = utility::time_in_ms();
+
+  for (auto& [subscriber_id, subscriber] : subscribers_) {
+    if (!subscriber.admitted_ || now - subscriber.progress_sent_at_ < progress_interval_) {
+      continue;
+    }
+    subscriber.progress_sent_at_ = now;
+    for (const auto& [host_id, progress_update] : progress_updates_) {
+      auto& sent = subscriber.progress_sent_[host_id];
+
+      if (sent.sequence_nr_ >= progress_update.sequence_nr_) {
+        continue;
+      }
+      if (progress_update.latest_key_frame_ != -1 && progress_update.latest_key_frame_ != sent.key_frame_ &&
+          progress_update.latest_key_frame_ == progress_update.key_frame_ &&
+          progress_update.key_frame_package_ != progress_update.latest_) {
+        transport_->Send(progress_update.key_frame_package_.data(), progress_update.key_frame_package_.size(), subscriber.address_);
+      }
+      transport_->Send(progress_update.latest_.data(), progress_update.latest_.size(), subscriber.address_);
+      sent.sequence_nr_ = progress_update.sequence_nr_;
+      sent.key_frame_ = progress_update.latest_key_frame_;
+    }
+  }
+}
+
+void Relay::EraseSubscriber(uint64_t host_id) {
+  subscribers_.erase(host_id);
+  progress_updates_.erase(host_id);
+  liveness_.Remove(host_id);
+  for (auto& [subscriber_id, subscriber] : subscribers_) {
+    subscriber.progress_sent_.erase(host_id);
+  }
+}
+
+void Relay::TerminateTimedOutSubscribers() {
+  bool lobby_changed = false;
+
+  liveness_.Advance([this](uint64_t host_id) { subscribers_.at(host_id).connection_.SetIsMissing(); },
+                    [this, &lobby_changed](uint64_t host_id) {
+                      const auto& subscriber = subscribers_.at(host_id);
+
+                      std::cout << subscriber.connection_.name() << " timed out, connection terminated" << "\n";
+                      lobby_changed = lobby_changed || subscriber.admitted_;
+                      EraseSubscriber(host_id);
+                    });
+  if (lobby_changed) {
+    PrintLobby();
+  }
+}
+
+void Relay::PrintLobby() const {
+  std::cout << "-----\n";
+  for (const auto& [host_id, subscriber] : subscribers_) {
+    if (subscriber.admitted_) {
+      std::cout << subscriber.connection_.name() << " - " << ToString(subscriber.state_) << "\n";
+    }
+  }
+  std::cout << std::flush;
+}
+
+bool Relay::Poll(int max_wait_ms) {
+  char buffer[2500];
+  sockaddr_in from_addr{};
+
+  static_assert(sizeof(buffer) >= sizeof(ReliablePackage) && sizeof(buffer) >= sizeof(UnreliablePackage));
+
+  auto size = transport_->Receive(buffer, sizeof(buffer), from_addr, max_wait_ms);
+
+  if (size == SOCKET_ERROR) {
+    return false;
+  }
+  TerminateTimedOutSubscribers();
+  if (size >= static_cast<ssize_t>(sizeof(PackageHeader))) {
+    const auto header = reinterpret_cast<const PackageHeader*>(buffer);
+
+    if (header->Verify()) {
+      switch (header->channel()) {
+        case Channel::Unreliable:
+          HandleUnreliableChannel(size, buffer);
+          break;
+        case Channel::Reliable:
+          HandleReliableChannel(size, buffer, from_addr);
+          break;
+        default:
+          break;
+      }
+    }
+  }
+  SendProgressUpdates();
+
+  return true;
+}
+
+void Relay::Run(const std::atomic<bool>& cancelled) {
+  std::cout << "Relay running, max " << max_players_ << " players" << std::endl;
+
+  while (!cancelled.load(std::memory_order_acquire)) {
+    if (!Poll(kWaitForIncomingPackages)) {
+      break;
+    }
+  }
+}
+
+} // namespace network
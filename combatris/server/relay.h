@@ -0,0 +1,115 @@
+#pragma once
+
+#include "network/udp_client_server.h"
+#include "network/connection.h"
+#include "network/liveness_monitor.h"
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <unordered_map>
+
+#if !defined(_WIN64)
+#include <netinet/in.h>
+#endif
+
+namespace network {
+
+// Datagrams of the relay, a datagram received tells where it came from, which is where the datagrams for the player who
+// sent it go
+class RelayTransport {
+ public:
+  virtual ~RelayTransport() noexcept {}
+
+  virtual ssize_t Receive(void* buff, size_t max_size, sockaddr_in& from_addr, int max_wait_ms) = 0;
+
+  virtual ssize_t Send(const void* buff, size_t size, const sockaddr_in& to_addr) = 0;
+};
+
+// The clients send from a port of their own and receive on the game port, so the replies go to the game port
+class UDPRelayTransport final : public RelayTransport {
+ public:
+  explicit UDPRelayTransport(int port) : server_(port), port_(port) {}
+
+  inline bool is_open() const { return server_.is_open(); }
+
+  virtual ssize_t Receive(void* buff, size_t max_size, sockaddr_in& from_addr, int max_wait_ms) override;
+
+  virtual ssize_t Send(const void* buff, size_t size, const sockaddr_in& to_addr) override {
+    return server_.Send(buff, size, to_addr);
+  }
+
+ private:
+  UDPServer server_;
+  int port_;
+};
+
+// Star topology relay, the clients set COMBATRIS_BROADCAST_IP to the address of the relay and all traffic is
+// fanned out by the relay instead of being broadcasted by the clients. Reliable packages are forwarded as soon as
+// they arrive, progress updates are coalesced to the latest update per player and sent at most once every
+// progress interval to each subscriber.
+class Relay final {
+ public:
+  Relay(std::unique_ptr<RelayTransport> transport, size_t max_players, int progress_interval);
+
+  Relay(const Relay&) = delete;
+
+  // Handles one datagram, or none if nothing arrived within max_wait_ms, and sends the progress updates that are due.
+  // Returns false if receiving failed.
+  bool Poll(int max_wait_ms);
+
+  void Run(const std::atomic<bool>& cancelled);
+
+ private:
+  struct Subscriber {
+    struct ProgressSent {
+      int64_t sequence_nr_ = -1;
+      int key_frame_ = -1;
+    };
+
+    Subscriber(const std::string& name, const PackageArray& package_array, const sockaddr_in& address)
+        : connection_(name, package_array), address_(address) {}
+
+    Connection connection_;
+    sockaddr_in address_;
+    GameState state_ = GameState::None;
+    bool admitted_ = false;
+    int64_t progress_sent_at_ = 0;
+    std::unordered_map<uint64_t, ProgressSent> progress_sent_;
+  };
+
+  struct ProgressUpdate {
+    std::vector<char> latest_;
+    uint32_t sequence_nr_ = 0;
+    int latest_key_frame_ = -1;
+    std::vector<char> key_frame_package_;
+    int key_frame_ = -1;
+  };
+
+  void HandleReliableChannel(ssize_t size, const char* buffer, const sockaddr_in& from_addr);
+
+  void HandleUnreliableChannel(ssize_t size, const char* buffer);
+
+  void SendRefused(const Subscriber& subscriber, const Header& join_header);
+
+  bool UpdateLobby(uint64_t host_id, Subscriber& subscriber, const Package& package);
+
+  void FanOut(const char* buffer, size_t size);
+
+  void SendProgressUpdates();
+
+  void EraseSubscriber(uint64_t host_id);
+
+  void TerminateTimedOutSubscribers();
+
+  void PrintLobby() const;
+
+  std::unique_ptr<RelayTransport> transport_;
+  size_t max_players_;
+  int progress_interval_;
+  std::unordered_map<uint64_t, Subscriber> subscribers_;
+  std::unordered_map<uint64_t, ProgressUpdate> progress_updates_;
+  LivenessMonitor liveness_;
+};
+
+} // namespace network
@@ -1,15 +1,26 @@
 #include "utility/timer.h"
+#include "utility/frame_scheduler.h"
+#include "utility/auto_repeat.h"
+#include "utility/threadsafe_queue.h"
 #include "game/tetrion.h"
 
 #include <set>
+#include <thread>
 #include <functional>
 #include <unordered_map>
 
 namespace {
 
+using Clock = std::chrono::steady_clock;
+using UniqueWindowPtr = std::unique_ptr<SDL_Window, utility::function_caller<void(SDL_Window*), &SDL_DestroyWindow>>;
+
 // DAS settings
-const int64_t kAutoRepeatInitialDelay = 190; // milliseconds
-const int64_t kAutoRepeatSubsequentDelay = 45; // milliseconds
+const auto kAutoRepeatInitialDelay = std::chrono::milliseconds(190);
+const auto kAutoRepeatSubsequentDelay = std::chrono::milliseconds(45);
+
+// Frame rate on the menu, the pause screen and the game over screen
+const int kIdleFrameRate = 15;
+const int kDefaultRefreshRate = 60;
 
 constexpr int HatValueToButtonValue(Uint8 value) { return (0xFF << 8) | value; }
 
@@ -78,6 +89,16 @@ class Combatris {
   enum class ButtonType { AxisMotion, HatButton, JoyButton };
   using RepeatFunc = std::function<void()>;
 
+  // An input handed from the main thread to the simulation thread, at the time SDL queued it
+  struct Input {
+    enum class Type { None, Control, Release, AxisRelease, WindowChanged };
+
+    Type type_ = Type::None;
+    Tetrion::Controls control_ = Tetrion::Controls::None;
+    int lines_ = 0;
+    Clock::time_point time_;
+  };
+
   Combatris() {
     if (SDL_Init(SDL_INIT_EVERYTHING) != 0) {
       std::cout << "SDL_Init Error: " << SDL_GetError() << std::endl;
@@ -89,11 +110,30 @@ class Combatris {
     }
     SDL_JoystickEventState(SDL_ENABLE);
     SDL_SetHint(SDL_HINT_JOYSTICK_ALLOW_BACKGROUND_EVENTS, "1");
-    tetrion_ = std::make_shared<Tetrion>();
+    window_.reset(SDL_CreateWindow("", SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, kWidth, kHeight,
+                                   SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI));
+    if (!window_) {
+      std::cout << "Failed to create window : " << SDL_GetError() << std::endl;
+      exit(-1);
+    }
+    Uint32 renderer_flags = SDL_RENDERER_ACCELERATED | SDL_RENDERER_TARGETTEXTURE;
+
+    if (UseVsync()) {
+      renderer_flags |= SDL_RENDERER_PRESENTVSYNC;
+    }
+    renderer_ = std::make_unique<Renderer>(window_.get(), renderer_flags);
+    if (!renderer_->is_open()) {
+      exit(-1);
+    }
+    tetrion_ = std::make_shared<Tetrion>(renderer_.get());
+    SDL_RaiseWindow(window_.get());
   }
 
   ~Combatris() {
+    // The textures of the game are released to the renderer, which is stopped before the window is destroyed
     tetrion_.reset();
+    renderer_.reset();
+    window_.reset();
     DetachJoystick(joystick_index_);
     SDL_Quit();
     TTF_Quit();
@@ -185,24 +225,42 @@ class Combatris {
   }
 
   template <Tetrion::Controls control>
-  void Repeatable(Tetrion::Controls& previous_control, RepeatFunc& func, int& repeat_count, int64_t& time_since_last_auto_repeat) {
+  void Repeatable(Tetrion::Controls& previous_control, RepeatFunc& func, AutoRepeat& auto_repeat, Clock::time_point at) {
     if (control == previous_control) {
       return;
     }
-    repeat_count = 0;
     previous_control = control;
     func = [this]() { tetrion_->GameControl(control); };
-    time_since_last_auto_repeat = kAutoRepeatInitialDelay;
+    auto_repeat.Press(at);
   }
 
-  opt::optional<std::pair<ButtonType, SDL_Event>> PollEvent(int repeat_count) {
-    SDL_Event event;
+  // The time the event was queued by SDL, its timestamp is in ms since SDL was initialised
+  static Clock::time_point EventTime(const SDL_Event& event, Clock::time_point now) {
+    const auto ticks = SDL_GetTicks();
 
-    if (!SDL_PollEvent(&event)) {
-      return {};
+    if (event.common.timestamp > ticks) {
+      return now;
     }
+    return now - std::chrono::milliseconds(ticks - event.common.timestamp);
+  }
+
+  // Refresh rate of the display the window is on
+  int GetRefreshRate() const {
+    SDL_DisplayMode mode;
+
+    if (SDL_GetCurrentDisplayMode(SDL_GetWindowDisplayIndex(window_.get()), &mode) != 0 || mode.refresh_rate <= 0) {
+      return kDefaultRefreshRate;
+    }
+    return mode.refresh_rate;
+  }
+
+  // The joysticks are handled on the main thread, the simulation thread is handed the control
+  Input TranslateEvent(SDL_Event event) {
+    Input input;
     auto button_type = ButtonType::JoyButton;
+    auto current_control = Tetrion::Controls::None;
 
+    input.time_ = EventTime(event, Clock::now());
     if (SDL_JOYHATMOTION == event.type) {
       button_type = ButtonType::HatButton;
       event.type = (event.jhat.value == 0) ? SDL_JOYBUTTONUP : SDL_JOYBUTTONDOWN;
@@ -211,68 +269,142 @@ class Combatris {
         event.jbutton.button = event.jhat.value;
       }
     } else if (use_axismotion_ && SDL_JOYAXISMOTION == event.type) {
-      if (0 == event.jaxis.value && 0 == repeat_count) {
-        event.type = SDL_FIRSTEVENT;
-      } else {
-        button_type = ButtonType::AxisMotion;
-        event.type = (0 == event.jaxis.value) ? SDL_JOYBUTTONUP : SDL_JOYBUTTONDOWN;
+      // A centred axis only releases a repeating control, whether one repeats is known on the simulation thread
+      if (0 == event.jaxis.value) {
+        input.type_ = Input::Type::AxisRelease;
+        return input;
       }
+      button_type = ButtonType::AxisMotion;
+      event.type = SDL_JOYBUTTONDOWN;
     }
 
-    return opt::make_optional(std::make_pair(button_type, event));
+    switch (event.type) {
+      case SDL_KEYDOWN:
+        current_control = TranslateKeyboardCommands(event);
+        break;
+      case SDL_JOYBUTTONDOWN:
+        current_control = TranslateJoystickCommands(button_type, event);
+        break;
+      case SDL_KEYUP:
+      case SDL_JOYBUTTONUP:
+        input.type_ = Input::Type::Release;
+        break;
+      case SDL_WINDOWEVENT:
+        if (SDL_WINDOWEVENT_SIZE_CHANGED == event.window.event || SDL_WINDOWEVENT_EXPOSED == event.window.event) {
+          input.type_ = Input::Type::WindowChanged;
+        }
+        break;
+      case SDL_RENDER_TARGETS_RESET:
+      case SDL_RENDER_DEVICE_RESET:
+        input.type_ = Input::Type::WindowChanged;
+        break;
+      case SDL_JOYDEVICEADDED:
+        AttachJoystick(event.jbutton.which);
+        break;
+      case SDL_JOYDEVICEREMOVED:
+        DetachJoystick(event.jbutton.which);
+        break;
+    }
+    if (Tetrion::Controls::None != current_control) {
+      input.type_ = Input::Type::Control;
+      input.control_ = current_control;
+      if (Tetrion::Controls::DebugSendLine == current_control) {
+        input.lines_ = 9 - (SDL_SCANCODE_9 - event.key.keysym.scancode);
+      }
+    }
+    return input;
   }
 
+  // The main thread waits for the events and hands the input over, the game is run on the simulation thread and drawn
+  // on the render thread. An input is handled as soon as it arrives, no thread waits for a frame to be drawn.
   void Play() {
-    bool quit = false;
-    DeltaTimer delta_timer;
-    int repeat_count = 0;
-    int64_t time_since_last_auto_repeat = 0;
-    int64_t auto_repeat_threshold = kAutoRepeatInitialDelay;
+    std::thread simulation([this, refresh_rate = GetRefreshRate()]() { Simulate(refresh_rate); });
+    SDL_Event event;
+
+    while (SDL_WaitEvent(&event) && SDL_QUIT != event.type) {
+      if (renderer_->window_event() == event.type) {
+        renderer_->UpdateWindow();
+        continue;
+      }
+      const auto input = TranslateEvent(event);
+
+      if (Tetrion::Controls::Quit == input.control_) {
+        break;
+      }
+      if (Input::Type::None != input.type_) {
+        inputs_.Push(input);
+      }
+    }
+    inputs_.Cancel();
+    simulation.join();
+  }
+
+  void Simulate(int refresh_rate) {
+    DeltaTimer render_delta_timer;
+    bool render = true;
+    FrameScheduler frame_scheduler(GetFrameRate(refresh_rate), kIdleFrameRate);
+    AutoRepeat auto_repeat(kAutoRepeatInitialDelay, kAutoRepeatSubsequentDelay);
     std::function<void()> function_to_repeat;
     Tetrion::Controls previous_control = Tetrion::Controls::None;
+    auto simulated_until = Clock::now();
 
-    while (!quit) {
-      while (auto poll_result = PollEvent(repeat_count)) {
-        auto [button_type, event] = *poll_result;
-
-        if (SDL_QUIT == event.type) {
-          quit = true;
-          break;
+    // The simulation is advanced to the time of each input before the input is applied
+    auto advance_to = [this, &simulated_until](Clock::time_point at) {
+      if (at > simulated_until) {
+        tetrion_->Update(std::chrono::duration<double>(at - simulated_until).count());
+        simulated_until = at;
+      }
+    };
+    auto run_auto_repeat = [&](Clock::time_point until) {
+      auto_repeat.Run(until, [&](Clock::time_point at) {
+        advance_to(at);
+        if (function_to_repeat) {
+          function_to_repeat();
         }
-        auto current_control = Tetrion::Controls::None;
-
-        switch (event.type) {
-          case SDL_KEYDOWN:
-            current_control = TranslateKeyboardCommands(event);
-            break;
-          case SDL_JOYBUTTONDOWN:
-            current_control = TranslateJoystickCommands(button_type, event);
-            break;
-          case SDL_KEYUP:
-          case SDL_JOYBUTTONUP:
-            repeat_count = 0;
+      });
+    };
+
+    while (!inputs_.is_cancelled()) {
+      Input input;
+
+      while (inputs_.Pop(input, std::chrono::milliseconds(0))) {
+        const auto event_time = std::max(input.time_, simulated_until);
+
+        // Repeats due before the event happened are applied first, a key released stops them from then on
+        run_auto_repeat(event_time);
+        advance_to(event_time);
+
+        switch (input.type_) {
+          case Input::Type::AxisRelease:
+            if (!auto_repeat.active()) {
+              break;
+            }
+            [[fallthrough]];
+          case Input::Type::Release:
+            auto_repeat.Release();
             function_to_repeat = nullptr;
             previous_control = Tetrion::Controls::None;
             break;
-          case SDL_JOYDEVICEADDED:
-            AttachJoystick(event.jbutton.which);
+          case Input::Type::WindowChanged:
+            tetrion_->WindowChanged();
             break;
-          case SDL_JOYDEVICEREMOVED:
-            DetachJoystick(event.jbutton.which);
+          default:
             break;
         }
-        if (Tetrion::Controls::None == current_control) {
+        if (Input::Type::Control != input.type_) {
           continue;
         }
+        const auto current_control = input.control_;
+
         switch (current_control) {
           case Tetrion::Controls::Left:
-            Repeatable<Tetrion::Controls::Left>(previous_control, function_to_repeat, repeat_count, time_since_last_auto_repeat);
+            Repeatable<Tetrion::Controls::Left>(previous_control, function_to_repeat, auto_repeat, event_time);
             break;
           case Tetrion::Controls::Right:
-            Repeatable<Tetrion::Controls::Right>(previous_control, function_to_repeat, repeat_count, time_since_last_auto_repeat);
+            Repeatable<Tetrion::Controls::Right>(previous_control, function_to_repeat, auto_repeat, event_time);
             break;
           case Tetrion::Controls::SoftDrop:
-            Repeatable<Tetrion::Controls::SoftDrop>(previous_control, function_to_repeat, repeat_count, time_since_last_auto_repeat);
+            Repeatable<Tetrion::Controls::SoftDrop>(previous_control, function_to_repeat, auto_repeat, event_time);
             break;
           case Tetrion::Controls::Start:
             tetrion_->NewGame();
@@ -280,12 +412,9 @@ class Combatris {
           case Tetrion::Controls::Pause:
             tetrion_->Pause();
             break;
-          case Tetrion::Controls::Quit:
-            quit = true;
-            break;
           case Tetrion::Controls::DebugSendLine:
 #if !defined(NDEBUG)
-            tetrion_->GameControl(Tetrion::Controls::DebugSendLine, 9 - (SDL_SCANCODE_9 - event.key.keysym.scancode));
+            tetrion_->GameControl(Tetrion::Controls::DebugSendLine, input.lines_);
 #endif
             break;
           default:
@@ -293,21 +422,20 @@ class Combatris {
             break;
         }
         if (kAutoRepeatControls.count(current_control) == 0) {
-          repeat_count = 0;
+          auto_repeat.Release();
           function_to_repeat = nullptr;
           previous_control = Tetrion::Controls::None;
         }
       }
-      if (previous_control != Tetrion::Controls::None &&
-          (time_in_ms() - time_since_last_auto_repeat) >= auto_repeat_threshold) {
-        if (function_to_repeat) {
-          function_to_repeat();
-        }
-        auto_repeat_threshold = (0 == repeat_count) ? kAutoRepeatInitialDelay : kAutoRepeatSubsequentDelay;
-        repeat_count++;
-        time_since_last_auto_repeat = time_in_ms();
+      run_auto_repeat(Clock::now());
+      advance_to(Clock::now());
+      // The frame is dropped while the render thread is still busy with the last one, the next one is due at once
+      if (render && tetrion_->CanRender()) {
+        tetrion_->Render(render_delta_timer.GetDelta());
       }
-      tetrion_->Update(delta_timer.GetDelta());
+      const bool idle = !auto_repeat.active() && tetrion_->IsIdle();
+
+      render = frame_scheduler.Wait(idle, [&]() { return !inputs_.empty() || auto_repeat.IsDue(Clock::now()); }) || idle;
     }
   }
 
@@ -316,7 +444,10 @@ class Combatris {
   std::string joystick_name_;
   SDL_Joystick* joystick_ = nullptr;
   bool use_axismotion_ = false;
+  UniqueWindowPtr window_;
+  std::unique_ptr<Renderer> renderer_;
   std::shared_ptr<Tetrion> tetrion_ = nullptr;
+  ThreadSafeQueue<Input> inputs_;
 };
 
 int main(int, char *[]) {
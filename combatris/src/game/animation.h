@@ -9,16 +9,16 @@ namespace {
 
 const SDL_Rect kMatrixRc = { kMatrixStartX, kMatrixStartY, kMatrixWidth, kMatrixHeight };
 
-void SetBlackBackground(SDL_Renderer* renderer) {
-  SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
-  SDL_RenderFillRect(renderer, &kMatrixRc);
+void SetBlackBackground(Renderer* renderer) {
+  renderer->SetDrawColor(0, 0, 0, 0);
+  renderer->FillRect(&kMatrixRc);
 }
 
 } // namespace
 
 class Animation {
 public:
-  Animation(SDL_Renderer *renderer,  const std::shared_ptr<Assets>& assets) : renderer_(renderer), assets_(assets) {}
+  Animation(Renderer* renderer,  const std::shared_ptr<Assets>& assets) : renderer_(renderer), assets_(assets) {}
 
   Animation(const Animation&) = delete;
 
@@ -28,7 +28,10 @@ public:
 
   virtual std::pair<bool, Event::Type> IsReady() const = 0;
 
-  operator SDL_Renderer *() const { return renderer_; }
+  // The same frame is drawn until something is pressed
+  virtual bool IsStill() const { return false; }
+
+  operator Renderer* () const { return renderer_; }
 
   const Assets& GetAsset() const { return *assets_; }
 
@@ -38,19 +41,21 @@ protected:
   double x_ = 0.0;
   double y_ = 0.0;
 
-  void RenderCopy(SDL_Texture *texture, const SDL_Rect& rc) { SDL_RenderCopy(*this, texture, nullptr, &rc); }
+  void RenderCopy(Texture *texture, const SDL_Rect& rc) { renderer_->Copy(texture, nullptr, &rc); }
+
+  inline Renderer* renderer() const { return renderer_; }
 
 private:
-  SDL_Renderer* renderer_;
+  Renderer* renderer_;
   std::shared_ptr<Assets> assets_ = nullptr;
 };
 
 class ScoreAnimation final : public Animation {
  public:
-  ScoreAnimation(SDL_Renderer* renderer,  const std::shared_ptr<Assets>& assets,  const Position& pos, int score)
-      : Animation(renderer, assets) {
-    int width, height;
-    std::tie(texture_, width, height) = CreateTextureFromText(*this, GetAsset().GetFont(Bold30), std::to_string(score), Color::Coral);
+  ScoreAnimation(Renderer* renderer,  const std::shared_ptr<Assets>& assets,  const Position& pos, int score)
+      : Animation(renderer, assets), atlas_(assets->GetGlyphAtlas(Bold30)), text_(std::to_string(score)) {
+    const int width = atlas_.Width(text_);
+    const int height = atlas_.height();
 
     auto x = col_to_pixel_adjusted(pos.col()) + Center(kMinoWidth * 4, width);
     auto y = row_to_pixel_adjusted(pos.row());
@@ -72,42 +77,59 @@ class ScoreAnimation final : public Animation {
     const double kIncY = delta * 75.0;
 
     rc_.y = static_cast<int>(y_);
-    RenderCopy(texture_.get(), rc_);
+    atlas_.Render(rc_.x, rc_.y, text_, Color::Coral);
     y_ -= kIncY;
   }
 
   virtual std::pair<bool, Event::Type> IsReady() const override { return std::make_pair(y_ <= end_pos_, Event::Type::None); }
 
  private:
+  GlyphAtlas& atlas_;
+  std::string text_;
   SDL_Rect rc_;
-  UniqueTexturePtr texture_ = nullptr;
   double end_pos_;
 };
 
 class LinesClearedAnimation final : public Animation {
  public:
-  LinesClearedAnimation(SDL_Renderer *renderer, const std::shared_ptr<Assets>& assets, const Lines& lines)
+  // Each line is drawn once into a strip, the strips are moved by the animation
+  LinesClearedAnimation(Renderer* renderer, const std::shared_ptr<Assets>& assets, const Lines& lines)
       : Animation(renderer, assets), lines_(lines) {
     end_pos_ = ((kRows - lines.at(0).row_) + lines.size() + 1.5) * kMinoHeight;
+    if (!renderer->TargetSupported()) {
+      return;
+    }
+    auto target = renderer->GetTarget();
+
+    for (const auto& line : lines_) {
+      auto strip = renderer->CreateTexture(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, kMatrixWidth, kMinoHeight);
+
+      renderer->SetTarget(strip.get());
+      renderer->SetTextureBlendMode(strip.get(), SDL_BLENDMODE_BLEND);
+      renderer->SetDrawColor(0, 0, 0, 0);
+      renderer->Clear();
+      AddMinos(line, 0, 0);
+      GetAsset().GetMinoAtlas().Flush();
+      strips_.push_back(std::move(strip));
+    }
+    renderer->SetTarget(target);
   }
 
   virtual void Render(double delta) override {
     const double kIncY = delta * 550.0;
     const double direction = (abs_y_ < kMinoHeight) ? -1 : 1;
 
-    for (const auto& line : lines_) {
-      auto y = row_to_pixel_adjusted(line.row_) + y_;
-
-      const auto& minos = line.minos_;
-
-      for (int l = kVisibleColStart; l < kVisibleColEnd; ++l) {
-        auto x = col_to_pixel_adjusted(l);
+    for (size_t i = 0; i < lines_.size(); ++i) {
+      const auto x = col_to_pixel_adjusted(kVisibleColStart);
+      const auto y = static_cast<int>(row_to_pixel_adjusted(lines_[i].row_) + y_);
 
-        const auto& tetromino = GetAsset().GetTetromino(static_cast<Tetromino::Type>(minos[l]));
-
-        tetromino->Render(x, static_cast<int>(y));
+      if (strips_.empty()) {
+        AddMinos(lines_[i], x, y);
+      } else {
+        RenderCopy(strips_[i].get(), { x, y, kMatrixWidth, kMinoHeight });
       }
     }
+    GetAsset().GetMinoAtlas().Flush();
     y_ += (kIncY * direction);
     abs_y_ += kIncY;
   }
@@ -115,49 +137,58 @@ class LinesClearedAnimation final : public Animation {
   virtual std::pair<bool, Event::Type> IsReady() const override { return std::make_pair(abs_y_ >= end_pos_, Event::Type::None); }
 
  private:
+  void AddMinos(const Line& line, int x, int y) const {
+    for (int col = kVisibleColStart; col < kVisibleColEnd; ++col) {
+      if (line.minos_[col] > kEmptyID) {
+        GetAsset().GetMinoAtlas().Add(x + (col - kVisibleColStart) * kMinoWidth, y, line.minos_[col]);
+      }
+    }
+  }
+
   double abs_y_ = 0.0;
   Lines lines_;
   double end_pos_;
+  std::vector<UniqueTexturePtr> strips_;
 };
 
 class CountDownAnimation final : public Animation {
  public:
-  CountDownAnimation(SDL_Renderer *renderer, const std::shared_ptr<Assets>& assets, int countdown, Event::Type type)
-      : Animation(renderer, assets), type_(type), countdown_(countdown) {
-    CreateTexture(countdown_);
+  CountDownAnimation(Renderer* renderer, const std::shared_ptr<Assets>& assets, int countdown, Event::Type type,
+                     double elapsed = 0.0)
+      : Animation(renderer, assets), type_(type), countdown_(countdown), ticks_(elapsed), atlas_(assets->GetGlyphAtlas(Normal200)) {
+    SetText(countdown_);
   }
 
   virtual void Render(double delta) override {
     SetBlackBackground(*this);
-    RenderCopy(texture_.get(), rc_);
+    atlas_.Render(x_pos_, kMatrixStartY + 100, text_, Color::White);
     ticks_ += delta;
     if (ticks_ >= 1.0) {
       countdown_--;
-      CreateTexture(countdown_);
+      SetText(countdown_);
       ticks_ = 0.0;
     }
   }
 
   virtual std::pair<bool, Event::Type> IsReady() const override { return std::make_pair(countdown_ - 1 < 0.0, type_); }
 
-  void CreateTexture(int i) {
-    int width, height;
-
-    std::tie(texture_, width, height) = CreateTextureFromText(*this, GetAsset().GetFont(Normal200), std::to_string(i), Color::White);
-    rc_ = { kMatrixStartX + Center(kMatrixWidth, width), kMatrixStartY + 100, width, height };
+  void SetText(int i) {
+    text_ = std::to_string(i);
+    x_pos_ = kMatrixStartX + Center(kMatrixWidth, atlas_.Width(text_));
   }
 
  private:
   Event::Type type_;
   int countdown_;
-  double ticks_ = 0.0;
-  SDL_Rect rc_;
-  UniqueTexturePtr texture_;
+  double ticks_;
+  GlyphAtlas& atlas_;
+  std::string text_;
+  int x_pos_ = 0;
 };
 
 class MessageAnimation final : public Animation {
  public:
-  MessageAnimation(SDL_Renderer *renderer, const std::shared_ptr<Assets>& assets, const std::string& msg, Color color, double display_speed = 45.0)
+  MessageAnimation(Renderer* renderer, const std::shared_ptr<Assets>& assets, const std::string& msg, Color color, double display_speed = 45.0)
       : Animation(renderer, assets), display_speed_(display_speed) {
     int width, height;
 
@@ -169,7 +200,7 @@ class MessageAnimation final : public Animation {
   }
 
   virtual void Render(double delta) override {
-    SDL_SetTextureAlphaMod(texture_.get(), static_cast<Uint8>(alpha_));
+    renderer()->SetTextureAlphaMod(texture_.get(), static_cast<Uint8>(alpha_));
     rc_.y = static_cast<int>(y_);
     RenderCopy(texture_.get(), rc_);
 
@@ -189,19 +220,13 @@ private:
 
 class OnFloorAnimation final : public Animation {
  public:
-  OnFloorAnimation(SDL_Renderer *renderer, const std::shared_ptr<Assets>& assets, const std::shared_ptr<TetrominoSprite>& tetromino_sprite)
-      : Animation(renderer, assets), tetromino_sprite_(tetromino_sprite), tetromino_(tetromino_sprite->tetromino()) {
-    alpha_texture_ = assets->GetAlphaTextures(tetromino_sprite_->tetromino().type());
-    SDL_GetTextureAlphaMod(alpha_texture_.get(), &alpha_saved_);
-    SDL_SetTextureAlphaMod(alpha_texture_.get(), static_cast<Uint8>(kAlpha));
-  }
-
-  virtual ~OnFloorAnimation() noexcept { SDL_SetTextureAlphaMod(alpha_texture_.get(), alpha_saved_); }
+  OnFloorAnimation(Renderer* renderer, const std::shared_ptr<Assets>& assets, const std::shared_ptr<TetrominoSprite>& tetromino_sprite)
+      : Animation(renderer, assets), tetromino_sprite_(tetromino_sprite), tetromino_(tetromino_sprite->tetromino()) {}
 
   virtual void Render(double) override {
-    SDL_RenderSetClipRect(*this, &kMatrixRc);
-    tetromino_sprite_->Render(alpha_texture_);
-    SDL_RenderSetClipRect(*this, nullptr);
+    renderer()->SetClipRect(&kMatrixRc);
+    tetromino_sprite_->Render(kAlpha);
+    renderer()->SetClipRect(nullptr);
   }
 
   virtual std::pair<bool, Event::Type> IsReady() const override {
@@ -210,15 +235,13 @@ class OnFloorAnimation final : public Animation {
 
 private:
   const Uint8 kAlpha = 150;
-  Uint8 alpha_saved_;
-  std::shared_ptr<SDL_Texture> alpha_texture_;
   std::shared_ptr<TetrominoSprite> tetromino_sprite_;
   const Tetromino& tetromino_;
 };
 
 class PauseAnimation final : public Animation {
  public:
-  PauseAnimation(SDL_Renderer *renderer, const std::shared_ptr<Assets>& assets, bool& unpause_pressed)
+  PauseAnimation(Renderer* renderer, const std::shared_ptr<Assets>& assets, bool& unpause_pressed)
       : Animation(renderer, assets), unpause_pressed_(unpause_pressed) {
     int width, height;
 
@@ -234,6 +257,8 @@ class PauseAnimation final : public Animation {
 
   virtual std::pair<bool, Event::Type> IsReady() const override { return std::make_pair(unpause_pressed_, Event::Type::UnPause); }
 
+  virtual bool IsStill() const override { return true; }
+
 private:
   bool& unpause_pressed_;
   UniqueTexturePtr texture_;
@@ -242,7 +267,7 @@ private:
 
 class SplashScreenAnimation final : public Animation {
  public:
-  SplashScreenAnimation(SDL_Renderer *renderer, const std::shared_ptr<CombatrisMenu>& menu, const std::shared_ptr<Assets>& assets)
+  SplashScreenAnimation(Renderer* renderer, const std::shared_ptr<CombatrisMenu>& menu, const std::shared_ptr<Assets>& assets)
       : Animation(renderer, assets), menu_view_(renderer, { kMatrixStartX, 0, kMatrixWidth, kMenuHeight }, assets->fonts(), menu, menu.get()) {
     int width, height;
 
@@ -262,6 +287,8 @@ class SplashScreenAnimation final : public Animation {
 
   virtual std::pair<bool, Event::Type> IsReady() const override { return std::make_pair(false, Event::Type::None); }
 
+  virtual bool IsStill() const override { return true; }
+
 private:
   UniqueTexturePtr texture_1_;
   UniqueTexturePtr texture_2_;
@@ -273,7 +300,7 @@ private:
 
 class GameOverAnimation final : public Animation {
  public:
-  GameOverAnimation(SDL_Renderer *renderer, const std::shared_ptr<CombatrisMenu>& menu, const std::shared_ptr<Assets>& assets)
+  GameOverAnimation(Renderer* renderer, const std::shared_ptr<CombatrisMenu>& menu, const std::shared_ptr<Assets>& assets)
       : Animation(renderer, assets), menu_view_(renderer, { kMatrixStartX, 0, kMatrixWidth, kMenuHeight }, assets->fonts(), menu, menu.get()) {
     int width, height;
 
@@ -288,8 +315,8 @@ class GameOverAnimation final : public Animation {
   }
 
   virtual void Render(double) override {
-    SDL_SetRenderDrawColor(*this, 0, 0, 0, 0);
-    SDL_RenderFillRect(*this, &blackbox_rc_);
+    renderer()->SetDrawColor(0, 0, 0, 0);
+    renderer()->FillRect(&blackbox_rc_);
     RenderCopy(texture_1_.get(), rc_1_);
     RenderCopy(texture_2_.get(), rc_2_);
     RenderCopy(texture_3_.get(), rc_3_);
@@ -298,6 +325,8 @@ class GameOverAnimation final : public Animation {
 
   virtual std::pair<bool, Event::Type> IsReady() const override { return std::make_pair(false, Event::Type::None); }
 
+  virtual bool IsStill() const override { return true; }
+
 private:
   UniqueTexturePtr texture_1_;
   UniqueTexturePtr texture_2_;
@@ -312,7 +341,7 @@ private:
 // We make this class generic when we have more gifs
 class HourglassAnimation final : public Animation {
  public:
-  HourglassAnimation(SDL_Renderer* renderer, const std::shared_ptr<Assets>& assets, const std::shared_ptr<MultiPlayer>& multi_player)
+  HourglassAnimation(Renderer* renderer, const std::shared_ptr<Assets>& assets, const std::shared_ptr<MultiPlayer>& multi_player)
       : Animation(renderer, assets), multi_player_(multi_player), textures_(GetAsset().GetHourGlassTextures()) {
     int width, height;
 
@@ -346,5 +375,5 @@ class HourglassAnimation final : public Animation {
   UniqueTexturePtr text_;
   SDL_Rect rc_;
   std::shared_ptr<MultiPlayer> multi_player_;
-  std::vector<std::shared_ptr<SDL_Texture>> textures_;
+  std::vector<std::shared_ptr<Texture>> textures_;
 };
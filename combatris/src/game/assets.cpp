@@ -12,13 +12,7 @@ const std::string kAssetFolder = "assets/";
 const std::string kAssetFolder = "../../assets/";
 #endif
 
-void DeleteTexture(SDL_Texture* texture) {
-  if (texture != nullptr) {
-    SDL_DestroyTexture(texture);
-  }
-}
-
-SDL_Texture* LoadTexture(SDL_Renderer *renderer, const std::string& name, Color transparent_color = Color::None) {
+SDL_Surface* LoadSurface(Renderer *renderer, const std::string& name) {
   if (SDL_WasInit(SDL_INIT_EVERYTHING) == 0 || nullptr == renderer) {
     return nullptr;
   }
@@ -29,19 +23,24 @@ SDL_Texture* LoadTexture(SDL_Renderer *renderer, const std::string& name, Color
     std::cout << "Failed to load surface " << full_path << " error : " << SDL_GetError() << std::endl;
     exit(-1);
   }
+  return surface;
+}
+
+UniqueTexturePtr LoadTexture(Renderer *renderer, const std::string& name, Color transparent_color = Color::None) {
+  UniqueSurfacePtr surface(LoadSurface(renderer, name));
+
+  if (!surface) {
+    return nullptr;
+  }
   if (Color::Transparent == transparent_color) {
     const auto c = GetColor(transparent_color);
 
-    SDL_SetColorKey(surface, 1, SDL_MapRGB(surface->format, c.r, c.g, c.b));
+    SDL_SetColorKey(surface.get(), 1, SDL_MapRGB(surface->format, c.r, c.g, c.b));
   }
-  auto texture = SDL_CreateTextureFromSurface(renderer, surface);
-
-  SDL_FreeSurface(surface);
-
-  return texture;
+  return renderer->CreateTextureFromSurface(std::move(surface));
 }
 
-SDL_Texture* LoadTexture(SDL_Renderer *renderer, const std::string& name, int i, Color transparent_color = Color::None) {
+UniqueTexturePtr LoadTexture(Renderer *renderer, const std::string& name, int i, Color transparent_color = Color::None) {
   return LoadTexture(renderer, name + "_" + std::to_string(i) + ".bmp", transparent_color);
 }
 
@@ -83,27 +82,40 @@ std::vector<TextureAssetData> kTextures {
 
 } // namespace
 
-Assets::Assets(SDL_Renderer *renderer) : fonts_(std::make_shared<Fonts>()) {
+Assets::Assets(Renderer *renderer) : renderer_(renderer), fonts_(std::make_shared<Fonts>()) {
+  std::vector<SDL_Surface*> minos;
+
+  for (const auto& data : kTetrominoAssetData) {
+    minos.push_back(LoadSurface(renderer, data.image_name_));
+  }
+  mino_atlas_ = std::make_shared<MinoAtlas>(renderer, minos);
+  std::for_each(minos.begin(), minos.end(), [](auto surface) { SDL_FreeSurface(surface); });
   for (const auto& data : kTetrominoAssetData) {
-    tetrominos_.push_back(std::make_shared<Tetromino>(
-        renderer, data.type_, data.color_, data.rotations_,
-        std::shared_ptr<SDL_Texture>(LoadTexture(renderer, data.image_name_), DeleteTexture)));
-    alpha_textures_.push_back(std::shared_ptr<SDL_Texture>(LoadTexture(renderer, data.image_name_), DeleteTexture));
+    tetrominos_.push_back(std::make_shared<Tetromino>(data.type_, data.color_, data.rotations_, mino_atlas_));
   }
   for (const auto& data : kTextures) {
-    textures_.push_back(std::shared_ptr<SDL_Texture>(LoadTexture(renderer, data.name_, data.transparent_color_), DeleteTexture));
+    textures_.push_back(LoadTexture(renderer, data.name_, data.transparent_color_));
   }
   for (int i = 1; i <=24; ++i) {
-    hourglass_textures_.push_back(std::shared_ptr<SDL_Texture>(LoadTexture(renderer, "Hourglass", i), DeleteTexture));
+    hourglass_textures_.push_back(LoadTexture(renderer, "Hourglass", i));
   }
   std::for_each(kFontsToPreload.begin(), kFontsToPreload.end(), [this](const auto& f) { fonts_->Get(f); });
 }
 
-std::tuple<std::shared_ptr<SDL_Texture>, int, int> Assets::GetTexture(Type type) const {
-  auto texture = textures_.at(static_cast<int>(type));
-  int w, h;
+GlyphAtlas& Assets::GetGlyphAtlas(const Font& font) const {
+  auto& atlas = glyph_atlases_[font];
 
-  SDL_QueryTexture(texture.get(), nullptr, nullptr, &w, &h);
+  if (!atlas) {
+    atlas = std::make_unique<GlyphAtlas>(renderer_, GetFont(font));
+  }
+  return *atlas;
+}
+
+std::tuple<std::shared_ptr<Texture>, int, int> Assets::GetTexture(Type type) const {
+  auto texture = textures_.at(static_cast<int>(type));
 
-  return std::make_tuple(texture, w, h);
+  if (!texture) {
+    return std::make_tuple(texture, 0, 0);
+  }
+  return std::make_tuple(texture, texture->width(), texture->height());
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "utility/fonts.h"
+#include "utility/glyph_atlas.h"
 #include "game/predefined_fonts.h"
 #include "utility/function_caller.h"
 #include "game/tetromino.h"
@@ -9,7 +10,7 @@ class Assets final {
  public:
   enum class Type { Checkmark, Circle };
 
-  explicit Assets(SDL_Renderer *renderer);
+  explicit Assets(Renderer *renderer);
 
   ~Assets() noexcept = default;
 
@@ -21,22 +22,27 @@ class Assets final {
 
   std::shared_ptr<Fonts> fonts() { return fonts_; }
 
-  std::tuple<std::shared_ptr<SDL_Texture>, int, int> GetTexture(Type type) const;
+  // Created the first time a font is asked for, text drawn with it does not allocate textures
+  GlyphAtlas& GetGlyphAtlas(const Font& font) const;
+
+  std::tuple<std::shared_ptr<Texture>, int, int> GetTexture(Type type) const;
 
   std::shared_ptr<const Tetromino> GetTetromino(Tetromino::Type type) const { return tetrominos_.at(static_cast<int>(type) - 1); }
 
   const std::vector<std::shared_ptr<const Tetromino>>& GetTetrominos() const { return tetrominos_; }
 
-  std::shared_ptr<SDL_Texture> GetAlphaTextures(Tetromino::Type type) const { return alpha_textures_.at(static_cast<int>(type) - 1); }
+  MinoAtlas& GetMinoAtlas() const { return *mino_atlas_; }
 
-  std::vector<std::shared_ptr<SDL_Texture>> GetHourGlassTextures() const { return hourglass_textures_; }
+  std::vector<std::shared_ptr<Texture>> GetHourGlassTextures() const { return hourglass_textures_; }
 
  private:
    using UniqueFontPtr = std::unique_ptr<TTF_Font, function_caller<void(TTF_Font*), &TTF_CloseFont>>;
 
+  Renderer* renderer_;
   std::vector<std::shared_ptr<const Tetromino>> tetrominos_;
-  std::vector<std::shared_ptr<SDL_Texture>> textures_;
-  std::vector<std::shared_ptr<SDL_Texture>> alpha_textures_;
-  std::vector<std::shared_ptr<SDL_Texture>> hourglass_textures_;
+  std::vector<std::shared_ptr<Texture>> textures_;
+  std::shared_ptr<MinoAtlas> mino_atlas_;
+  std::vector<std::shared_ptr<Texture>> hourglass_textures_;
   std::shared_ptr<Fonts> fonts_;
+  mutable std::unordered_map<Font, std::unique_ptr<GlyphAtlas>> glyph_atlases_;
 };
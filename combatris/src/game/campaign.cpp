@@ -5,20 +5,13 @@ namespace {
 const SDL_Rect kSinglePlayerRC =  { 0, 0, kWidth, kHeight };
 const SDL_Rect kBattleRC =  { 0, 0, kWidth + kMultiPlayerWidthAddOn, kHeight };
 
-void SetupCampaignWindow(SDL_Window* window, SDL_Renderer* renderer, bool is_single_player) {
-  const auto& rc = is_single_player ? kSinglePlayerRC : kBattleRC;
-
-  SDL_RenderSetLogicalSize(renderer, rc.w, rc.h);
-  SDL_SetWindowSize(window, rc.w, rc.h);
-}
-
 inline const SDL_Rect& GetWindowRc(bool is_single_player) {
   return (is_single_player) ? kSinglePlayerRC : kBattleRC;
 }
 
-void RenderWindowBackground(SDL_Renderer* renderer, const SDL_Rect& rc) {
-  SDL_SetRenderDrawColor(renderer, 1, 40, 135, 255);
-  SDL_RenderFillRect(renderer, &rc);
+void RenderWindowBackground(Renderer* renderer, const SDL_Rect& rc) {
+  renderer->SetDrawColor(1, 40, 135, 255);
+  renderer->FillRect(&rc);
 }
 
 std::string ToString(CampaignType type) {
@@ -41,7 +34,7 @@ std::string ToString(CampaignType type) {
 
 } // namespace
 
-Campaign::Campaign(SDL_Renderer* renderer, Events& events, const std::shared_ptr<Assets>& assets, const std::shared_ptr<Matrix>& matrix) : renderer_(renderer), events_(events), assets_(assets), matrix_(matrix) {
+Campaign::Campaign(Renderer* renderer, Events& events, const std::shared_ptr<Assets>& assets, const std::shared_ptr<Matrix>& matrix) : renderer_(renderer), events_(events), assets_(assets), matrix_(matrix) {
   level_ = std::make_shared<Level>(renderer_, 150, events_, assets_);
   AddListener(level_.get());
   tetromino_generator_ = std::make_shared<TetrominoGenerator>(matrix_, level_, events_, assets_);
@@ -66,7 +59,7 @@ Campaign::Campaign(SDL_Renderer* renderer, Events& events, const std::shared_ptr
   AddListener(multi_player_.get());
 }
 
-void Campaign::Set(SDL_Window* window, CampaignType type) {
+void Campaign::Set(CampaignType type) {
   if (type == type_) {
     return;
   }
@@ -96,17 +89,91 @@ void Campaign::Set(SDL_Window* window, CampaignType type) {
     default:
       break;
   }
-  SetupCampaignWindow(window, renderer_, IsSinglePlayerCampaign(*this));
-  SDL_SetWindowTitle(window, title.c_str());
+  const auto& rc = GetWindowRc(IsSinglePlayerCampaign(*this));
+
+  renderer_->SetLogicalSize(rc.w, rc.h);
+  renderer_->SetWindow(title, rc.w, rc.h);
   SetupCampaign(type_);
+  InvalidateBackground();
   events_.Push(Event::Type::SetCampaign, type_);
 }
 
+void Campaign::Tick(double delta_time) {
+  std::for_each(panes_.begin(), panes_.end(), [delta_time](const auto& pane) { pane->Tick(delta_time); });
+  TakeDamage();
+}
+
+void Campaign::TakeDamage() {
+  for (const auto& pane : panes_) {
+    const auto rc = pane->TakeDamage();
+    const auto previous = damage_;
+
+    SDL_UnionRect(&previous, &rc, &damage_);
+  }
+}
+
+bool Campaign::UpdateFrame(double delta_time) {
+  TakeDamage();
+
+  auto damage = std::exchange(damage_, SDL_Rect{ 0, 0, 0, 0 });
+
+  if (!background_valid_) {
+    UpdateBackground();
+    damage = GetWindowRc(IsSinglePlayerCampaign(*this));
+  }
+  if (!frame_) {
+    return true;
+  }
+  if (SDL_RectEmpty(&damage)) {
+    return false;
+  }
+  // Only the damaged area of the frame is redrawn, the panes are clipped to it
+  renderer_->SetTarget(frame_.get());
+  renderer_->SetClipRect(&damage);
+  renderer_->Copy(background_.get(), &damage, &damage);
+  std::for_each(panes_.begin(), panes_.end(), [delta_time](const auto& pane) { pane->Render(delta_time); });
+  renderer_->SetClipRect(nullptr);
+  renderer_->SetTarget(nullptr);
+
+  return true;
+}
+
 void Campaign::Render(double delta_time) {
-  RenderWindowBackground(renderer_, GetWindowRc(IsSinglePlayerCampaign(*this)));
+  const auto& window_rc = GetWindowRc(IsSinglePlayerCampaign(*this));
+
+  if (frame_) {
+    renderer_->Copy(frame_.get(), nullptr, &window_rc);
+    return;
+  }
+  RenderBackground();
   std::for_each(panes_.begin(), panes_.end(), [delta_time](const auto& pane) { pane->Render(delta_time); });
 }
 
+void Campaign::RenderBackground() {
+  RenderWindowBackground(renderer_, GetWindowRc(IsSinglePlayerCampaign(*this)));
+  std::for_each(panes_.begin(), panes_.end(), [](const auto& pane) { pane->RenderBackground(); });
+}
+
+// Without render target support the background and the panes are drawn every frame
+void Campaign::UpdateBackground() {
+  background_valid_ = true;
+  background_.reset();
+  frame_.reset();
+  if (!renderer_->TargetSupported()) {
+    return;
+  }
+  const auto& rc = GetWindowRc(IsSinglePlayerCampaign(*this));
+
+  background_ = renderer_->CreateTexture(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, rc.w, rc.h);
+  renderer_->SetTarget(background_.get());
+  renderer_->SetTextureBlendMode(background_.get(), SDL_BLENDMODE_NONE);
+  renderer_->Clear();
+  RenderBackground();
+  renderer_->SetTarget(nullptr);
+  frame_ = renderer_->CreateTexture(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, rc.w, rc.h);
+  renderer_->SetTextureBlendMode(frame_.get(), SDL_BLENDMODE_NONE);
+}
+
 Event Campaign::PreprocessEvent(const Event& event) {
   std::for_each(event_listeners_.begin(), event_listeners_.end(), [&event](const auto& r) { r->Update(event); });
   return event;
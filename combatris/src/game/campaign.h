@@ -14,14 +14,27 @@
 
 class Campaign {
  public:
-  Campaign(SDL_Renderer* renderer, Events& events, const std::shared_ptr<Assets>& assets, const std::shared_ptr<Matrix>& matrix);
+  Campaign(Renderer* renderer, Events& events, const std::shared_ptr<Assets>& assets, const std::shared_ptr<Matrix>& matrix);
 
   operator CampaignType() const { return type_; }
 
-  void Set(SDL_Window* window, CampaignType type);
+  void Set(CampaignType type);
 
+  // Ticks the panes, the areas they damaged are kept until the next UpdateFrame
+  void Tick(double delta_time);
+
+  // Redraws the damaged areas into the frame, false if the frame is unchanged
+  bool UpdateFrame(double delta_time);
+
+  // Draws the frame, the background layer and every pane when render targets are not supported
   void Render(double delta_time);
 
+  // The background layer is redrawn before the next frame, the window was resized or the render targets were lost
+  void InvalidateBackground() {
+    background_valid_ = false;
+    multi_player_->InvalidateBoards();
+  }
+
   Event PreprocessEvent(const Event& event);
 
   void Reset() {
@@ -52,8 +65,15 @@ class Campaign {
 
   void SetupCampaign(CampaignType type);
 
+  void RenderBackground();
+
+  // Adds the areas the panes damaged since they were last asked
+  void TakeDamage();
+
+  void UpdateBackground();
+
  private:
-  SDL_Renderer* renderer_;
+  Renderer* renderer_;
   Events& events_;
   std::shared_ptr<Assets> assets_;
   std::shared_ptr<TetrominoGenerator> tetromino_generator_;
@@ -72,4 +92,9 @@ class Campaign {
   std::vector<PaneInterface*> panes_;
   std::vector<EventListener*> event_listeners_;
   CampaignType type_ = CampaignType::None;
+  UniqueTexturePtr background_;
+  bool background_valid_ = false;
+  SDL_Rect damage_ = { 0, 0, 0, 0 };
+  // Kept between frames as the back buffer is undefined after a present
+  UniqueTexturePtr frame_;
 };
@@ -5,8 +5,6 @@
 #include <iomanip>
 
 namespace {
-std::mt19937 kGenerator{ std::random_device{}() };
-std::uniform_int_distribution<size_t> kDistribution(0, kVisibleCols - 1);
 
 const std::vector<int> kEmptyRow = { kBorderID, kBorderID, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, kBorderID, kBorderID };
 const std::vector<int> kSolidRow = { kBorderID, kBorderID, kSolidID, kSolidID, kSolidID, kSolidID,  kSolidID,
@@ -24,21 +22,21 @@ void Print(const Matrix::Type& matrix) {
   }
 }
 
-void RenderGrid(SDL_Renderer* renderer) {
+void RenderGrid(utility::Renderer* renderer) {
   const SDL_Color gray { 51, 55, 66, 255 };
 
-  SDL_SetRenderDrawColor(renderer, gray.r, gray.g, gray.b, gray.a);
+  renderer->SetDrawColor(gray.r, gray.g, gray.b, gray.a);
   SDL_Rect rc { kMatrixStartX, kMatrixStartY, kMatrixWidth, kMatrixHeight };
-  SDL_RenderFillRect(renderer, &rc);
+  renderer->FillRect(&rc);
 
-  SDL_SetRenderDrawColor(renderer, 0, 0, 0, 0);
+  renderer->SetDrawColor(0, 0, 0, 0);
 
   rc = { 0, kMatrixStartY + 1, kMinoWidth - 2, kMinoHeight - 2 };
 
   for (int row = 0; row < kVisibleRows; ++row) {
     rc.x = kMatrixStartX + 1;
     for (int col = 0; col < kVisibleCols; ++col) {
-      SDL_RenderFillRect(renderer, &rc);
+      renderer->FillRect(&rc);
       rc.x += kMinoWidth;
     }
     rc.y += kMinoHeight;
@@ -108,14 +106,15 @@ int MoveLinesUp(int lines, Matrix::Type& matrix) {
   return lines;
 }
 
-void InsertSolidLines(int lines, Matrix::Type& matrix) {
+// The distributions in <random> may give different results on different platforms, mt19937 doesn't (input stream)
+void InsertSolidLines(int lines, Matrix::Type& matrix, std::mt19937& generator) {
   int i = 0;
   int n = 0;
 
   for (int l = lines - 1; l >= 0; --l) {
     matrix[kVisibleRowEnd - l - 1] = kSolidRow;
     if (i % 2 == 0) {
-      n = static_cast<int>(kDistribution(kGenerator));
+      n = static_cast<int>(generator() % kVisibleCols);
     }
     i++;
     matrix[kVisibleRowEnd - l - 1][kVisibleRowStart + n] = kBombID;
@@ -133,16 +132,27 @@ void Matrix::Initialize() {
   matrix_ = master_matrix_;
 }
 
-void Matrix::Render(double) {
+void Matrix::RenderBackground() {
   RenderGrid(renderer_);
   for (int col = kVisibleColStart - 1; col < kVisibleColEnd + 1; ++col) {
     tetrominos_[kBorderID - 1]->Render(Position(row_to_visible(kVisibleRowStart - 1), col_to_visible(col)));
   }
+  for (int row = kVisibleRowStart; row < kVisibleRowEnd + 1; ++row) {
+    for (int col = kVisibleColStart - 1; col < kVisibleColEnd + 1; ++col) {
+      if (kBorderID == matrix_[row][col]) {
+        tetrominos_[kBorderID - 1]->Render(Position(row_to_visible(row), col_to_visible(col)));
+      }
+    }
+  }
+  tetrominos_[kBorderID - 1]->atlas().Flush();
+}
+
+void Matrix::Render(double) {
   for (int row = kVisibleRowStart; row < kVisibleRowEnd + 1; ++row) {
     for (int col = kVisibleColStart - 1; col < kVisibleColEnd + 1; ++col) {
       const int id = matrix_[row][col];
 
-      if (kEmptyID == id) {
+      if (kEmptyID == id || kBorderID == id) {
         continue;
       }
       const auto& tetromino = (id < kGhostAddOn) ? *tetrominos_[id - 1] : *tetrominos_[id - kGhostAddOn - 1];
@@ -155,22 +165,67 @@ void Matrix::Render(double) {
       }
     }
   }
+  tetrominos_[kBorderID - 1]->atlas().Flush();
+}
+
+SDL_Rect Matrix::TakeDamage() {
+  if (rendered_.size() != matrix_.size()) {
+    rendered_ = matrix_;
+    return { kMatrixStartX, kMatrixStartY, kMatrixWidth, kMatrixHeight };
+  }
+  int min_row = kRows, max_row = -1, min_col = kCols, max_col = -1;
+
+  for (int row = kVisibleRowStart; row < kVisibleRowEnd; ++row) {
+    for (int col = kVisibleColStart; col < kVisibleColEnd; ++col) {
+      if (matrix_[row][col] != rendered_[row][col]) {
+        min_row = std::min(min_row, row);
+        max_row = std::max(max_row, row);
+        min_col = std::min(min_col, col);
+        max_col = std::max(max_col, col);
+      }
+    }
+  }
+  if (max_row < 0) {
+    return { 0, 0, 0, 0 };
+  }
+  rendered_ = matrix_;
+
+  const Position pos(row_to_visible(min_row), col_to_visible(min_col));
+
+  return { pos.x(), pos.y(), (max_col - min_col + 1) * kMinoWidth, (max_row - min_row + 1) * kMinoHeight };
+}
+
+uint32_t Matrix::Hash() const {
+  uint32_t hash = 2166136261; // FNV-1a
+
+  for (int row = kVisibleRowStart; row < kVisibleRowEnd; ++row) {
+    for (int col = kVisibleColStart; col < kVisibleColEnd; ++col) {
+      hash = (hash ^ static_cast<uint32_t>(master_matrix_[row][col])) * 16777619;
+    }
+  }
+  return hash;
 }
 
 bool Matrix::InsertLines(int lines) {
+  if (journal_enabled_) {
+    journal_.emplace_back(Operation::Type::InsertLines, lines);
+  }
   lines = MoveLinesUp(lines, master_matrix_);
 
   if (lines <= 0) {
     return false;
   }
 
-  InsertSolidLines(lines, master_matrix_);
+  InsertSolidLines(lines, master_matrix_, generator_);
   matrix_ = master_matrix_;
 
   return true;
 }
 
 void Matrix::RemoveLines() {
+  if (journal_enabled_) {
+    journal_.emplace_back(Operation::Type::RemoveLines);
+  }
   Lines lines;
 
   for (int row = 0; row < kVisibleRowEnd; ++row) {
@@ -5,13 +5,37 @@
 #include "game/panes/pane_interface.h"
 
 #include <tuple>
+#include <random>
 
 class Matrix final : public PaneInterface {
  public:
   using Type = std::vector<std::vector<int>>;
   using CommitReturnType = std::tuple<Lines, TSpinType, bool>;
 
-  Matrix(SDL_Renderer* renderer, const std::vector<std::shared_ptr<const Tetromino>>& tetrominos)
+  // An operation that changed the matrix, replaying the operations on a matrix with the same seed gives the same result
+  struct Operation {
+    enum class Type { Commit, InsertLines, RemoveLines };
+
+    Operation(Type type, int lines = 0) : type_(type), lines_(lines) {}
+
+    Operation(Tetromino::Type tetromino, Tetromino::Angle angle, Tetromino::Move latest_move, const Position& pos)
+        : type_(Type::Commit), tetromino_(tetromino), angle_(angle), latest_move_(latest_move), pos_(pos) {}
+
+    Type type_;
+    Tetromino::Type tetromino_ = Tetromino::Type::Empty;
+    Tetromino::Angle angle_ = Tetromino::Angle::A0;
+    Tetromino::Move latest_move_ = Tetromino::Move::None;
+    Position pos_ = Position(0, 0);
+    int lines_ = 0;
+  };
+
+  struct Piece {
+    Tetromino::Type type_ = Tetromino::Type::Empty;
+    Tetromino::Angle angle_ = Tetromino::Angle::A0;
+    Position pos_ = Position(0, 0);
+  };
+
+  Matrix(utility::Renderer* renderer, const std::vector<std::shared_ptr<const Tetromino>>& tetrominos)
       : renderer_(renderer), tetrominos_(tetrominos) { Initialize(); }
 
   // Used by test suit
@@ -49,8 +73,39 @@ class Matrix final : public PaneInterface {
 
   virtual void Render(double) override;
 
+  virtual void RenderBackground() override;
+
+  // The cells that changed since the last call, compared with the cells as they were then
+  virtual SDL_Rect TakeDamage() override;
+
   virtual void Reset() override { Initialize(); }
 
+  // Seeds the generator used for the position of the bombs in the lines inserted
+  void SetSeed(uint64_t seed) { generator_.seed(static_cast<std::mt19937::result_type>(seed ^ (seed >> 32))); }
+
+  void EnableJournal(bool enable) {
+    journal_enabled_ = enable;
+    journal_.clear();
+  }
+
+  std::deque<Operation> TakeJournal() {
+    std::deque<Operation> journal;
+
+    std::swap(journal, journal_);
+
+    return journal;
+  }
+
+  const Piece& piece() const { return piece_; }
+
+  void RemovePiece() {
+    is_dirty_ = true;
+    piece_ = Piece();
+    matrix_ = master_matrix_;
+  }
+
+  uint32_t Hash() const;
+
   bool InsertLines(int lines);
 
   void RemoveLines();
@@ -64,10 +119,22 @@ class Matrix final : public PaneInterface {
     Insert(matrix_, pos, rotation_data);
   }
 
+  void Insert(Tetromino::Type type, Tetromino::Angle angle, const Position& pos) {
+    Insert(pos, tetrominos_.at(static_cast<int>(type) - 1)->GetRotationData(angle));
+    piece_ = { type, angle, pos };
+  }
+
   Position GetDropPosition(const Position& current_pos, const TetrominoRotationData& rotation_data) const;
 
   auto Commit(Tetromino::Type type, Tetromino::Angle angle, Tetromino::Move latest_move, const Position& current_pos) {
-    return Commit(type, latest_move, current_pos, tetrominos_.at(static_cast<int>(type) - 1)->GetRotationData(angle));
+    const auto& rotation_data = tetrominos_.at(static_cast<int>(type) - 1)->GetRotationData(angle);
+
+    if (journal_enabled_) {
+      journal_.emplace_back(type, angle, latest_move, GetDropPosition(current_pos, rotation_data));
+    }
+    piece_ = Piece();
+
+    return Commit(type, latest_move, current_pos, rotation_data);
   }
 
   CommitReturnType Commit(Tetromino::Type type, Tetromino::Move latest_move, const Position& pos, const TetrominoRotationData& rotation_data);
@@ -82,11 +149,16 @@ class Matrix final : public PaneInterface {
  private:
   friend bool operator==(const Matrix& rhs, const Matrix::Type& lhs);
 
-  SDL_Renderer* renderer_ = nullptr;
+  utility::Renderer* renderer_ = nullptr;
   std::vector<std::shared_ptr<const Tetromino>> tetrominos_;
   Type matrix_;
   Type master_matrix_;
+  Type rendered_;
   bool is_dirty_ = false;
+  std::mt19937 generator_{ std::random_device{}() };
+  bool journal_enabled_ = false;
+  std::deque<Operation> journal_;
+  Piece piece_;
 };
 
 inline bool operator==(const Matrix& rhs, const Matrix::Type& lhs) {
@@ -0,0 +1,62 @@
+#include "game/mino_atlas.h"
+
+#include <algorithm>
+
+namespace {
+
+using utility::UniqueSurfacePtr;
+
+const int kPadding = 2;
+const SDL_Color kBlack = { 0, 0, 0, 255 };
+
+} // namespace
+
+// The atlas is one row, a white block used for filled rectangles followed by the minos. The padding keeps scaled down
+// minos from sampling their neighbours.
+MinoAtlas::MinoAtlas(utility::Renderer* renderer, const std::vector<SDL_Surface*>& minos) : renderer_(renderer) {
+  white_rc_ = { 0, 0, kMinoWidth, kMinoHeight };
+  texture_width_ = kMinoWidth + kPadding;
+  texture_height_ = kMinoHeight;
+  for (auto surface : minos) {
+    if (nullptr == surface) {
+      mino_rcs_.push_back({ 0, 0, 0, 0 });
+      continue;
+    }
+    mino_rcs_.push_back({ texture_width_, 0, surface->w, surface->h });
+    texture_width_ += surface->w + kPadding;
+    texture_height_ = std::max(texture_height_, surface->h);
+  }
+  if (nullptr == renderer_) {
+    return;
+  }
+  auto atlas = UniqueSurfacePtr(SDL_CreateRGBSurfaceWithFormat(0, texture_width_, texture_height_, 32, SDL_PIXELFORMAT_ARGB8888));
+
+  if (!atlas) {
+    return;
+  }
+  SDL_FillRect(atlas.get(), &white_rc_, SDL_MapRGBA(atlas->format, 255, 255, 255, 255));
+  for (size_t i = 0; i < minos.size(); ++i) {
+    if (nullptr == minos[i]) {
+      continue;
+    }
+    SDL_Rect rc = mino_rcs_[i];
+
+    SDL_SetSurfaceBlendMode(minos[i], SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(minos[i], nullptr, atlas.get(), &rc);
+  }
+  texture_ = renderer_->CreateTextureFromSurface(std::move(atlas));
+  renderer_->SetTextureBlendMode(texture_.get(), SDL_BLENDMODE_BLEND);
+}
+
+void MinoAtlas::Add(int x, int y, int w, int h, int id, uint8_t alpha) {
+  const auto& src = mino_rcs_.at(id - 1);
+
+  if (src.w > 0) {
+    batch_.Add(src, { x, y, w, h }, { 255, 255, 255, alpha });
+  }
+}
+
+void MinoAtlas::AddGhost(int x, int y, SDL_Color color) {
+  AddRect({ x, y, kMinoWidth, kMinoHeight }, color);
+  AddRect({ x + 2, y + 2, kMinoWidth - 4, kMinoHeight - 4 }, kBlack);
+}
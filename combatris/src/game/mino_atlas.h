@@ -0,0 +1,36 @@
+#pragma once
+
+#include "game/constants.h"
+#include "utility/text.h"
+#include "utility/quad_batch.h"
+
+#include <vector>
+
+// The images of all minos in one texture. Minos, ghosts and the filled rectangles behind them are queued and drawn
+// together by Flush, the opacity of a mino is set per mino instead of on a copy of its texture.
+class MinoAtlas final {
+ public:
+  // The mino with id n is minos[n - 1], a missing image leaves the mino out
+  MinoAtlas(utility::Renderer* renderer, const std::vector<SDL_Surface*>& minos);
+
+  MinoAtlas(const MinoAtlas&) = delete;
+
+  void Add(int x, int y, int w, int h, int id, uint8_t alpha = 255);
+
+  inline void Add(int x, int y, int id, uint8_t alpha = 255) { Add(x, y, kMinoWidth, kMinoHeight, id, alpha); }
+
+  inline void AddRect(const SDL_Rect& rc, SDL_Color color) { batch_.Add(white_rc_, rc, color); }
+
+  void AddGhost(int x, int y, SDL_Color color);
+
+  inline void Flush() { batch_.Flush(renderer_, texture_.get(), texture_width_, texture_height_); }
+
+ private:
+  utility::Renderer* renderer_;
+  utility::UniqueTexturePtr texture_ = nullptr;
+  int texture_width_ = 0;
+  int texture_height_ = 0;
+  SDL_Rect white_rc_ = { 0, 0, 0, 0 };
+  std::vector<SDL_Rect> mino_rcs_;
+  utility::QuadBatch batch_;
+};
@@ -0,0 +1,64 @@
+#include "game/opponent_simulation.h"
+
+#include <iostream>
+
+using namespace network;
+
+namespace {
+
+bool IsTetromino(int type) { return type >= static_cast<int>(Tetromino::Type::I) && type <= static_cast<int>(Tetromino::Type::Z); }
+
+} // namespace
+
+bool OpponentSimulation::Apply(const InputEvent& input) {
+  if (!is_synced_) {
+    return false;
+  }
+  switch (input.type()) {
+    case InputEvent::Type::Lock:
+      if (!Fits(input.tetromino(), input.angle(), input.row(), input.col())) {
+        is_synced_ = false;
+        break;
+      }
+      matrix_.Commit(static_cast<Tetromino::Type>(input.tetromino()), static_cast<Tetromino::Angle>(input.angle()),
+                     static_cast<Tetromino::Move>(input.latest_move()), Position(input.row(), input.col()));
+      operations_++;
+      break;
+    case InputEvent::Type::Garbage:
+      matrix_.InsertLines(input.lines());
+      operations_++;
+      break;
+    case InputEvent::Type::KnockedOut:
+      matrix_.RemoveLines();
+      operations_++;
+      break;
+    case InputEvent::Type::BoardHash:
+      if (input.operations() == operations_ && input.hash() != matrix_.Hash()) {
+        std::cout << "Input stream out of sync after " << operations_ << " operations" << std::endl;
+        is_synced_ = false;
+      }
+      break;
+    default:
+      break;
+  }
+  matrix_.RemovePiece();
+
+  return is_synced_;
+}
+
+bool OpponentSimulation::Fits(int type, int angle, int row, int col) const {
+  if (!IsTetromino(type) || angle > static_cast<int>(Tetromino::Angle::A270)) {
+    return false;
+  }
+  const auto& shape = tetrominos_.at(type - 1)->GetRotationData(static_cast<Tetromino::Angle>(angle)).shape_;
+
+  return row + static_cast<int>(shape.size()) <= kRows + 1 && col + static_cast<int>(shape.at(0).size()) <= kCols;
+}
+
+void OpponentSimulation::SetPiece(const PieceState& piece) {
+  if (!Fits(piece.type_, piece.angle_, piece.row_, piece.col_)) {
+    matrix_.RemovePiece();
+    return;
+  }
+  matrix_.Insert(static_cast<Tetromino::Type>(piece.type_), static_cast<Tetromino::Angle>(piece.angle_), Position(piece.row_, piece.col_));
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "game/matrix.h"
+#include "network/protocol.h"
+
+// Headless copy of the matrix of another player, built from the input stream sent by that player
+class OpponentSimulation final {
+ public:
+  OpponentSimulation(const std::vector<std::shared_ptr<const Tetromino>>& tetrominos, uint64_t seed)
+      : tetrominos_(tetrominos), matrix_(nullptr, tetrominos) {
+    matrix_.SetSeed(seed);
+  }
+
+  OpponentSimulation(const OpponentSimulation&) = delete;
+
+  // Returns false if the matrix is out of sync with the matrix of the other player
+  bool Apply(const network::InputEvent& input);
+
+  void SetPiece(const network::PieceState& piece);
+
+  inline bool is_synced() const { return is_synced_; }
+
+  inline const Matrix& matrix() const { return matrix_; }
+
+ private:
+  bool Fits(int type, int angle, int row, int col) const;
+
+  std::vector<std::shared_ptr<const Tetromino>> tetrominos_;
+  Matrix matrix_;
+  uint32_t operations_ = 0;
+  bool is_synced_ = true;
+};
@@ -5,7 +5,7 @@
 class Goal final : public TextPane, public EventListener {
  public:
   // 578
-  Goal(SDL_Renderer* renderer, int offset, const std::shared_ptr<Assets>& assets) : TextPane(renderer, kMatrixStartX - kMinoWidth - (kBoxWidth + kSpace), (kMatrixStartY - kMinoHeight) + offset, "GOAL", assets) { Reset(); }
+  Goal(Renderer* renderer, int offset, const std::shared_ptr<Assets>& assets) : TextPane(renderer, kMatrixStartX - kMinoWidth - (kBoxWidth + kSpace), (kMatrixStartY - kMinoHeight) + offset, "GOAL", assets) { Reset(); }
 
   virtual void Reset() override {
     level_ = start_level_;
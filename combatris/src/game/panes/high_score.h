@@ -5,7 +5,7 @@
 
 class HighScore final : public TextPane, public EventListener {
  public:
-  HighScore(SDL_Renderer* renderer, const std::shared_ptr<Assets>& assets) :
+  HighScore(Renderer* renderer, const std::shared_ptr<Assets>& assets) :
       TextPane(renderer,  kMatrixEndX + kMinoWidth + kSpace, (kMatrixStartY - kMinoHeight) + 428, "HIGH SCORE", assets) {
     SetCaptionOrientation(TextPane::Orientation::Left);
     Read();
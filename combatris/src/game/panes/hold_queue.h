@@ -8,7 +8,7 @@ class HoldQueue final : public TextPane, public EventListener {
   static const int kX = kMatrixStartX - kMinoWidth - (kBoxWidth + kSpace);
   static const int kY = kMatrixStartY - kMinoHeight;
 
-  HoldQueue(SDL_Renderer *renderer,
+  HoldQueue(Renderer* renderer,
             const std::shared_ptr<TetrominoGenerator> &tetromino_generator,
             const std::shared_ptr<Assets> &assets)
       : TextPane(renderer, kX, kY, "HOLD", assets), tetromino_generator_(tetromino_generator) {
@@ -32,6 +32,8 @@ class HoldQueue final : public TextPane, public EventListener {
     ticks_ = 0.0;
     wait_for_lock_ = true;
     display_checkmark_ = true;
+    DamageBox();
+    Damage(rc_);
 
     return tetromino_sprite;
   }
@@ -45,17 +47,24 @@ class HoldQueue final : public TextPane, public EventListener {
 
   std::shared_ptr<TetrominoSprite> Get() { return tetromino_generator_->Get(tetromino_); }
 
-  virtual void Render(double delta_time) override {
+  virtual void Tick(double delta_time) override {
     const auto kDisplayTime = 0.4;
 
-    TextPane::Render(delta_time);
-
-    if (Tetromino::Type::Empty != tetromino_) {
-      assets_->GetTetromino(tetromino_)->RenderTetromino(x_ + 10, y_ + caption_height_ + 15);
+    if (!display_checkmark_) {
+      return;
     }
     ticks_ += delta_time;
     if (ticks_ >= kDisplayTime) {
       display_checkmark_ = false;
+      Damage(rc_);
+    }
+  }
+
+  virtual void Render(double delta_time) override {
+    TextPane::Render(delta_time);
+
+    if (Tetromino::Type::Empty != tetromino_) {
+      assets_->GetTetromino(tetromino_)->RenderTetromino(x_ + 10, y_ + caption_height_ + 15);
     }
     if (display_checkmark_) {
       Pane::RenderCopy(checkmark_texture_.get(), rc_);
@@ -65,6 +74,7 @@ class HoldQueue final : public TextPane, public EventListener {
   virtual void Reset() override {
     wait_for_lock_ = false;
     tetromino_ = Tetromino::Type::Empty;
+    DamageBox();
   }
 
   bool CanHold() const { return !wait_for_lock_; }
@@ -75,6 +85,6 @@ class HoldQueue final : public TextPane, public EventListener {
   bool display_checkmark_ = false;
   Tetromino::Type tetromino_ = Tetromino::Type::Empty;
   SDL_Rect rc_;
-  std::shared_ptr<SDL_Texture> checkmark_texture_;
+  std::shared_ptr<Texture> checkmark_texture_;
   const std::shared_ptr<TetrominoGenerator> tetromino_generator_;
 };
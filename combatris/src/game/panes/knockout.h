@@ -10,7 +10,7 @@ class Knockout final : public Pane, public EventListener {
   static const int kX = kMatrixStartX - kMinoWidth - (kCircleDim + kSpace);
   static const int kY = kMatrixStartY + 300;
 
-  Knockout(SDL_Renderer *renderer, const std::shared_ptr<Assets> &assets)
+  Knockout(Renderer* renderer, const std::shared_ptr<Assets> &assets)
       : Pane(renderer, kX, kY, assets) {
     std::tie(circle_texture_, circle_rc_.w, circle_rc_.h) = assets_->GetTexture(Assets::Type::Circle);
     circle_rc_ = { kX, kY, kCircleDim, kCircleDim };
@@ -31,9 +31,21 @@ class Knockout final : public Pane, public EventListener {
     Display(n_ko_);
     ticks_ = 0.0;
     show_plus_one_ = true;
+    DamageArea();
   }
 
-  virtual void Render(double delta_time) override {
+  virtual void Tick(double delta_time) override {
+    if (!show_plus_one_) {
+      return;
+    }
+    ticks_ += delta_time;
+    show_plus_one_ = (ticks_ < kDisplayTime);
+    if (!show_plus_one_) {
+      Damage(circle_rc_);
+    }
+  }
+
+  virtual void Render(double) override {
     if (0 == n_ko_) {
       return;
     }
@@ -41,16 +53,22 @@ class Knockout final : public Pane, public EventListener {
     Pane::RenderCopy(caption_texture_.get(), caption_rc_);
     if (show_plus_one_)  {
       Pane::RenderCopy(plus_one_texture_.get(), plus_one_rc_);
-      ticks_ += delta_time;
-      show_plus_one_ = (ticks_ < kDisplayTime);
     } else {
       Pane::RenderCopy(n_ko_texture_.get(), n_ko_rc_);
     }
   }
 
-  virtual void Reset() override { n_ko_ = 0; }
+  virtual void Reset() override {
+    n_ko_ = 0;
+    DamageArea();
+  }
 
  protected:
+  void DamageArea() {
+    Damage(circle_rc_);
+    Damage(caption_rc_);
+  }
+
   void Display(int ko) {
     std::tie(n_ko_texture_, n_ko_rc_.w, n_ko_rc_.h) = CreateTextureFromText(renderer_, assets_->GetFont(ObelixPro40), std::to_string(ko), Color::Yellow);
     n_ko_rc_.x = circle_rc_.x + Center(kCircleDim, n_ko_rc_.w);
@@ -61,7 +79,7 @@ class Knockout final : public Pane, public EventListener {
   double ticks_ = 0;
   bool show_plus_one_ = false;
   SDL_Rect circle_rc_;
-  std::shared_ptr<SDL_Texture> circle_texture_;
+  std::shared_ptr<Texture> circle_texture_;
   SDL_Rect caption_rc_;
   UniqueTexturePtr caption_texture_;
   SDL_Rect plus_one_rc_;
@@ -49,7 +49,8 @@ void Level::SetLevel(int lvl) {
 bool Level::WaitForMoveDown(double time_delta) {
   time_ += time_delta;
   if (time_ >= wait_time_) {
-    time_ = 0.0;
+    // The time past the step is kept so the gravity doesn't depend on the tick rate, a released piece starts over
+    time_ = (time_ >= wait_time_ * 2.0) ? 0.0 : time_ - wait_time_;
     return true;
   }
   return false;
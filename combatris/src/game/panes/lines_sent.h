@@ -6,7 +6,7 @@
 class LinesSent final : public TextPane, public EventListener {
  public:
   // 578
-  LinesSent(SDL_Renderer* renderer, int offset, const std::shared_ptr<Assets>& assets)
+  LinesSent(Renderer* renderer, int offset, const std::shared_ptr<Assets>& assets)
        : TextPane(renderer, kMatrixStartX - kMinoWidth - (kBoxWidth + kSpace),
                   (kMatrixStartY - kMinoHeight) + offset, "LINES SENT", assets) { Reset(); }
 
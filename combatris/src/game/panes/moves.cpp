@@ -43,9 +43,7 @@ void Moves::Update(const Event& event) {
   ticks_ = 0.0;
 }
 
-void Moves::Render(double delta_time) {
-  TextPane::Render(delta_time);
-
+void Moves::Tick(double delta_time) {
   ticks_ += delta_time;
   if (!box_cleared_ && ticks_ >= kDisplayTime) {
     ClearBox();
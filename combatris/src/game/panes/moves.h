@@ -5,7 +5,7 @@
 
 class Moves final : public TextPane, public EventListener {
  public:
-  Moves(SDL_Renderer* renderer, const std::shared_ptr<Assets>& assets) :
+  Moves(Renderer* renderer, const std::shared_ptr<Assets>& assets) :
       TextPane(renderer,  kMatrixEndX + kMinoWidth + kSpace, (kMatrixStartY - kMinoHeight) + 578 + 32, assets) {
     SetCaptionOrientation(TextPane::Orientation::Left);
   }
@@ -17,7 +17,7 @@ class Moves final : public TextPane, public EventListener {
 
   virtual void Update(const Event& event) override;
 
-  virtual void Render(double) override;
+  virtual void Tick(double delta_time) override;
 
  private:
   double ticks_ = 0;
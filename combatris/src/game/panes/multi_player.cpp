@@ -1,26 +1,23 @@
 #include "game/panes/multi_player.h"
+#include "network/matrix_state_codec.h"
 
 using namespace network;
 
 namespace {
 
-const int kMaxPlayers = 6;
+const int kMaxPlayers = 32;
+const size_t kVisiblePlayers = 6; // Three rows of two
 const int kTimesUpSoon = 15;
 const int kGameTime = 120;
-const double kUpdateInterval = 0.250;
+const double kConnectionQualityInterval = 1.0;
+const uint32_t kBoardHashInterval = 8;
+const SDL_Rect kPaneRc = { kX, kY, kMultiPlayerPaneWidth, kMultiPlayerPaneHeight };
 
-std::pair<UniqueTexturePtr, SDL_Rect> CreateTimerTexture(SDL_Renderer* renderer, const Assets& assets,
-                                                         const std::string& text, Color color = Color::White) {
-  auto [texture, width, height] = CreateTextureFromText(renderer, assets.GetFont(ObelixPro40), text, color);
-
-  return std::make_pair(std::move(texture), SDL_Rect{ kMatrixStartX, 5, width, height });
-}
-
-MatrixState GetMatrixState(const std::shared_ptr<Matrix>& m) {
+MatrixState GetMatrixState(const Matrix& m) {
   MatrixState matrix_state;
 
   int i = 0;
-  const auto& matrix = m->data();
+  const auto& matrix = m.data();
 
   for (int row = kVisibleRowStart; row < kVisibleRowEnd; ++row) {
     const auto& col_vec = matrix[row];
@@ -39,23 +36,91 @@ MatrixState GetMatrixState(const std::shared_ptr<Matrix>& m) {
 
 } // namespace
 
-MultiPlayer::MultiPlayer(SDL_Renderer* renderer, const std::shared_ptr<Matrix>& matrix, Events& events,
+MultiPlayer::MultiPlayer(Renderer* renderer, const std::shared_ptr<Matrix>& matrix, Events& events,
                          const std::shared_ptr<Assets>& assets)
-    : Pane(renderer, kX, kY, assets), matrix_(matrix), events_(events), timer_(kGameTime) {
-  std::tie(timer_texture_, timer_texture_rc_) = CreateTimerTexture(renderer, *assets, timer_.FormatTime(kGameTime));
+    : Pane(renderer, kX, kY, assets), matrix_(matrix), events_(events), timer_(kGameTime),
+      timer_atlas_(assets->GetGlyphAtlas(ObelixPro40)) {
+  SetTimerText(kGameTime);
 }
 
-void MultiPlayer::Update(const Event& event) {
+void MultiPlayer::Enable() {
+  enabled_ = true;
+  if (multiplayer_controller_) {
+    return;
+  }
+  // A connect started before the pane was last disabled is still pending, it's picked up when it's done
+  if (!connecting_.valid()) {
+    connecting_ = std::async(std::launch::async, [this] { return std::make_unique<MultiPlayerController>(this); });
+  }
+  SetStatus("Connecting ...");
+}
+
+void MultiPlayer::Disable() {
+  enabled_ = false;
+  status_texture_.reset();
+  Damage(kPaneRc);
+  Disconnect();
+  PollConnection();
+}
+
+// A controller that is done after the pane was disabled is dropped
+void MultiPlayer::PollConnection() {
+  if (!connecting_.valid() || connecting_.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+    return;
+  }
+  auto controller = connecting_.get();
+
+  if (!enabled_) {
+    return;
+  }
+  if (controller->has_failed()) {
+    SetStatus(controller->error());
+    return;
+  }
+  status_texture_.reset();
+  Damage(kPaneRc);
+  multiplayer_controller_ = std::move(controller);
+  multiplayer_controller_->Join();
+  input_stream_ = UseInputStream();
+  matrix_->EnableJournal(input_stream_);
+}
+
+void MultiPlayer::Disconnect() {
   if (!multiplayer_controller_) {
     return;
   }
+  multiplayer_controller_.reset();
+  Damage(kPaneRc);
+  matrix_->EnableJournal(false);
+  score_board_.clear();
+  players_.clear();
+  simulations_.clear();
+}
+
+void MultiPlayer::SetStatus(const std::string& status) {
+  int width, height;
+
+  std::tie(status_texture_, width, height) = CreateTextureFromText(renderer_, assets_->GetFont(Normal25), status, Color::White);
+  status_texture_rc_ = { kX + 5, kY + 5, std::min(width, kMultiPlayerPaneWidth - 10), height };
+  Damage(kPaneRc);
+}
+
+void MultiPlayer::Update(const Event& event) {
+  // The campaign is set while the controller is being brought up
   switch (event.type()) {
     case Event::Type::SetStartLevel:
       start_level_ = event.value_;
-      break;
+      return;
     case Event::Type::SetCampaign:
       campaign_type_ = ToCampaignType(event.value_);
+      return;
+    default:
       break;
+  }
+  if (!multiplayer_controller_) {
+    return;
+  }
+  switch (event.type()) {
     case Event::Type::CalculatedScore:
       accumulator_.AddScore(event.score_);
       if (IsBattleCampaign(campaign_type_) && event.value_ > 0) {
@@ -77,6 +142,7 @@ void MultiPlayer::Update(const Event& event) {
       multiplayer_controller_->SendUpdate(GameState::GameOver);
       break;
     case Event::Type::NextTetromino:
+      progress_scheduler_.Changed(true);
       if (IsBattleCampaign(campaign_type_) && !timer_.IsStarted()) {
         timer_.Start();
       }
@@ -84,6 +150,9 @@ void MultiPlayer::Update(const Event& event) {
     case Event::Type::MultiplayerStartGame:
       multiplayer_controller_->StartGame();
       break;
+    case Event::Type::BattleNextTetrominoGotLines:
+      progress_scheduler_.Changed(true);
+      break;
     case Event::Type::BattleNextTetrominoSuccessful:
       if (!IsBattleCampaign(campaign_type_)) {
         break;
@@ -104,7 +173,12 @@ void MultiPlayer::Update(const Event& event) {
   }
 }
 
-void MultiPlayer::Render(double delta_time) {
+void MultiPlayer::Tick(double delta_time) {
+  PollConnection();
+  if (multiplayer_controller_ && multiplayer_controller_->has_failed()) {
+    SetStatus(multiplayer_controller_->error());
+    Disconnect();
+  }
   if (!multiplayer_controller_) {
     return;
   }
@@ -112,22 +186,68 @@ void MultiPlayer::Render(double delta_time) {
     auto [updated, time_in_sec] = timer_.GetTimeInSeconds();
 
     if (updated) {
-      auto color = (time_in_sec <= kTimesUpSoon) ? Color::Red : Color::White;
-
-      std::tie(timer_texture_, timer_texture_rc_) = CreateTimerTexture(renderer_, *assets_, timer_.FormatTime(time_in_sec), color);
+      SetTimerText(time_in_sec, (time_in_sec <= kTimesUpSoon) ? Color::Red : Color::White);
       if (timer_.IsZero()) {
         timer_.Stop();
         events_.Push(Event::Type::GameOver);
       }
     }
   }
+  if (input_stream_) {
+    SendInputStream();
+  }
+  clock_ += delta_time;
+  if (clock_ - connection_quality_updated_at_ >= kConnectionQualityInterval) {
+    connection_quality_updated_at_ = clock_;
+    UpdateConnectionQuality();
+  }
+  if (matrix_->IsDirty()) {
+    progress_scheduler_.Changed(false);
+  }
+  if (progress_scheduler_.IsDue(clock_)) {
+    progress_scheduler_.Sent(clock_);
+    SendProgressUpdate();
+  }
+  multiplayer_controller_->Dispatch();
+  if (refused_) {
+    refused_ = false;
+    Disconnect();
+    SetStatus("The room is full");
+    return;
+  }
+  for (const auto& player : score_board_) {
+    if (player->TakeChanged()) {
+      player->UpdateBoard();
+      Damage(kPaneRc);
+    }
+  }
+}
+
+void MultiPlayer::Render(double) {
+  if (!multiplayer_controller_) {
+    if (status_texture_) {
+      Pane::SetDrawColor(renderer_, Color::Black);
+      Pane::FillRect(renderer_, kX, kY, kMultiPlayerPaneWidth, kMultiPlayerPaneHeight);
+      // Long error messages are cut at the edge of the pane
+      const SDL_Rect clip_rc = { 0, 0, status_texture_rc_.w, status_texture_rc_.h };
+
+      renderer_->Copy(status_texture_.get(), &clip_rc, &status_texture_rc_);
+    }
+    return;
+  }
   Pane::SetDrawColor(renderer_, Color::Black);
   Pane::FillRect(renderer_, kX, kY, kMultiPlayerPaneWidth, kMultiPlayerPaneHeight);
 
   int x_offset = 0;
   int y_offset = 0;
+  // The score board is sorted, so the leaders are shown. If we aren't one of them we take the last place shown.
+  const auto visible = std::min(score_board_.size(), kVisiblePlayers);
+  const auto us = std::find_if(score_board_.begin(), score_board_.end(), [this](const auto& p) { return IsUs(p->host_id()); });
+  const bool us_hidden = us != score_board_.end() && static_cast<size_t>(us - score_board_.begin()) >= visible;
+
+  for (size_t i = 0; i < visible; ++i) {
+    const auto& player = (us_hidden && i + 1 == visible) ? *us : score_board_[i];
 
-  for (const auto& player : score_board_) {
     player->Render((kBoxWidth + kSpaceBetweenBoxes) * x_offset, (kBoxHeight + kSpaceBetweenBoxes) * y_offset, IsUs(player->host_id()));
     x_offset++;
     if (x_offset > 1) {
@@ -136,19 +256,84 @@ void MultiPlayer::Render(double delta_time) {
     }
   }
   if (IsBattleCampaign(campaign_type_)) {
-    Pane::RenderCopy(timer_texture_.get(), timer_texture_rc_);
+    timer_atlas_.Render(kMatrixStartX, 5, timer_text_, timer_color_);
+  }
+}
+
+void MultiPlayer::NewGame() {
+  if (!multiplayer_controller_) {
+    return;
+  }
+  multiplayer_controller_->NewGame();
+  if (!input_stream_) {
+    return;
   }
-  ticks_progess_update_ += delta_time;
-  if (ticks_progess_update_ >= kUpdateInterval) {
-    ticks_progess_update_ = 0.0;
-    if (matrix_->IsDirty()) {
-      multiplayer_controller_->SendUpdate(accumulator_.lines_, accumulator_.score_, accumulator_.level_, GetMatrixState(matrix_));
+  const uint64_t seed = (static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}();
+
+  matrix_->SetSeed(seed);
+  matrix_->EnableJournal(true);
+  operations_sent_ = operations_since_hash_ = 0;
+  game_start_time_ = utility::time_in_ms();
+  multiplayer_controller_->SendSeed(seed);
+}
+
+void MultiPlayer::SendInputStream() {
+  const auto time = static_cast<uint32_t>(utility::time_in_ms() - game_start_time_);
+
+  for (const auto& operation : matrix_->TakeJournal()) {
+    switch (operation.type_) {
+      case Matrix::Operation::Type::Commit:
+        multiplayer_controller_->SendUpdate(InputEvent::Lock(static_cast<int>(operation.tetromino_), static_cast<int>(operation.angle_),
+                                                             operation.pos_.row(), operation.pos_.col(),
+                                                             static_cast<int>(operation.latest_move_), time));
+        break;
+      case Matrix::Operation::Type::InsertLines:
+        multiplayer_controller_->SendUpdate(InputEvent::Garbage(operation.lines_, time));
+        break;
+      case Matrix::Operation::Type::RemoveLines:
+        multiplayer_controller_->SendUpdate(InputEvent::KnockedOut(time));
+        break;
     }
+    operations_sent_++;
+    operations_since_hash_++;
+  }
+  if (operations_since_hash_ >= kBoardHashInterval) {
+    operations_since_hash_ = 0;
+    multiplayer_controller_->SendUpdate(InputEvent::BoardHash(operations_sent_, matrix_->Hash()));
+  }
+}
+
+void MultiPlayer::UpdateConnectionQuality() {
+  double rtt = 0.0;
+  double loss = 0.0;
+
+  for (const auto& [host_id, player] : players_) {
+    network::ConnectionStats stats;
+
+    if (!IsUs(host_id) && multiplayer_controller_->GetConnectionStats(host_id, stats)) {
+      rtt = std::max(rtt, stats.rtt_);
+      loss = std::max(loss, stats.loss_);
+    }
+  }
+  progress_scheduler_.SetConnectionQuality(rtt, loss);
+}
+
+// With the input stream only the tetromino in play is sent, but every key frame interval the matrix is sent
+// for the players that have missed the seed (joined during the game) or are out of sync
+void MultiPlayer::SendProgressUpdate() {
+  const auto& piece = matrix_->piece();
+
+  if (input_stream_ && (progress_updates_sent_++ % kKeyFrameInterval) != 0) {
+    multiplayer_controller_->SendUpdate(accumulator_.lines_, accumulator_.score_, accumulator_.level_,
+                                        PieceState{ static_cast<uint8_t>(piece.type_), static_cast<uint8_t>(piece.angle_),
+                                                    static_cast<uint8_t>(piece.pos_.row()), static_cast<uint8_t>(piece.pos_.col()) });
+  } else {
+    multiplayer_controller_->SendUpdate(accumulator_.lines_, accumulator_.score_, accumulator_.level_, GetMatrixState(*matrix_));
   }
-  multiplayer_controller_->Dispatch();
 }
 
 void MultiPlayer::SortScoreBoard() {
+  Damage(kPaneRc);
   if (IsBattleCampaign(campaign_type_)) {
     std::sort(score_board_.begin(), score_board_.end(), [](const auto& a, const auto& b) {
       if (GameState::Idle == b->state()) {
@@ -195,30 +380,42 @@ bool MultiPlayer::GotJoin(const std::string& name, uint64_t host_id)  {
   score_board_.push_back(
       players_.insert(std::make_pair(host_id, std::make_shared<Player>(renderer_, name, host_id, assets_)))
           .first->second);
+  Damage(kPaneRc);
 
   return true;
 }
 
 void MultiPlayer::GotLeave(uint64_t host_id) {
+  simulations_.erase(host_id);
   if (0 == players_.count(host_id)) {
+    // The relay sends us a leave when it refused our join
+    refused_ = refused_ || IsUs(host_id);
     return;
   }
   auto it = std::find_if(score_board_.begin(), score_board_.end(), [host_id](const auto& e) { return host_id == e->host_id(); });
 
   score_board_.erase(it);
   players_.erase(host_id);
+  Damage(kPaneRc);
 }
 
 void MultiPlayer::GotNewGame(uint64_t host_id) {
   if (IsUs(host_id)) {
     accumulator_.Reset(start_level_);
-    std::tie(timer_texture_, timer_texture_rc_) = CreateTimerTexture(renderer_, *assets_, timer_.FormatTime(kGameTime));
+    SetTimerText(kGameTime);
     for (auto& player : score_board_) {
       player->Reset();
     }
     events_.Push(Event::Type::MultiplayerResetCountDown);
   } else if (GameState::Waiting == game_state_) {
-    events_.Push(Event::Type::MultiplayerResetCountDown);
+    network::ConnectionStats stats;
+
+    // The countdown started when the other player sent the request, i.e. half a round trip ago
+    if (multiplayer_controller_->GetConnectionStats(host_id, stats)) {
+      events_.Push(Event::Type::MultiplayerResetCountDown, static_cast<int>(stats.rtt_ / 2.0));
+    } else {
+      events_.Push(Event::Type::MultiplayerResetCountDown);
+    }
   }
 }
 
@@ -240,41 +437,87 @@ void MultiPlayer::GotNewState(uint64_t host_id, network::GameState state) {
   if (IsUs(host_id)) {
     game_state_ = (GameState::None == state) ? game_state_ : state;
   }
-  auto& player = players_.at(host_id);
+  auto player = FindPlayer(host_id);
 
-  player->SetState(state);
+  if (player) {
+    player->SetState(state);
+  }
 }
 
 void MultiPlayer::GotProgressUpdate(uint64_t host_id, int lines, int score, int level, const MatrixState& state) {
-  auto& player = players_.at(host_id);
+  auto player = FindPlayer(host_id);
+
+  if (!player) {
+    return;
+  }
+  score = (IsBattleCampaign(campaign_type_)) ? -1 : score;
+  if (player->ProgressUpdate(lines, score, level)) {
+    SortScoreBoard();
+  }
+  if (simulations_.count(host_id) == 0 || !simulations_.at(host_id)->is_synced()) {
+    player->SetMatrixState(state);
+  }
+}
 
+void MultiPlayer::GotProgressUpdate(uint64_t host_id, int lines, int score, int level, const PieceState& piece) {
+  auto player = FindPlayer(host_id);
+
+  if (!player) {
+    return;
+  }
   score = (IsBattleCampaign(campaign_type_)) ? -1 : score;
   if (player->ProgressUpdate(lines, score, level)) {
     SortScoreBoard();
   }
-  player->SetMatrixState(state);
+  if (simulations_.count(host_id) > 0 && simulations_.at(host_id)->is_synced()) {
+    auto& simulation = simulations_.at(host_id);
+
+    simulation->SetPiece(piece);
+    player->SetMatrixState(GetMatrixState(simulation->matrix()));
+  }
+}
+
+void MultiPlayer::GotSeed(uint64_t host_id, uint64_t seed) {
+  if (players_.count(host_id) == 0) {
+    return;
+  }
+  simulations_[host_id] = std::make_unique<OpponentSimulation>(assets_->GetTetrominos(), seed);
+}
+
+void MultiPlayer::GotInput(uint64_t host_id, const InputEvent& input) {
+  if (simulations_.count(host_id) == 0 || players_.count(host_id) == 0) {
+    return;
+  }
+  auto& simulation = simulations_.at(host_id);
+
+  if (simulation->Apply(input)) {
+    players_.at(host_id)->SetMatrixState(GetMatrixState(simulation->matrix()));
+  }
 }
 
 void MultiPlayer::GotLines(uint64_t host_id, int lines) {
-  if (!IsBattleCampaign(campaign_type_)) {
+  auto player = FindPlayer(host_id);
+
+  if (!IsBattleCampaign(campaign_type_) || !player) {
     return;
   }
   if (!IsUs(host_id)) {
     got_lines_from_.push_back(host_id);
     events_.Push(Event::Type::BattleGotLines, lines);
   }
-  auto& player = players_.at(host_id);
-
   player->AddLinesSent(lines);
   SortScoreBoard();
 }
 
 void MultiPlayer::GotPlayerKnockedOut(uint64_t host_id) {
+  auto player = FindPlayer(host_id);
+
+  if (!player) {
+    return;
+  }
   if (IsUs(host_id)) {
     events_.Push(Event::Type::BattleYouDidKO);
   }
-  auto& player = players_.at(host_id);
-
   player->AddKO(1);
   SortScoreBoard();
 }
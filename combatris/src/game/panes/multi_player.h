@@ -1,13 +1,17 @@
 #pragma once
 
 #include "game/matrix.h"
+#include "game/opponent_simulation.h"
 #include "game/panes/accumlator.h"
 #include "game/panes/player.h"
 #include "game/panes/pane.h"
+#include "network/progress_scheduler.h"
+
+#include <future>
 
 class MultiPlayer final : public Pane, public EventListener,  public network::ListenerInterface {
  public:
-  MultiPlayer(SDL_Renderer* renderer, const std::shared_ptr<Matrix>& matrix, Events& events, const std::shared_ptr<Assets>& assets);
+  MultiPlayer(Renderer* renderer, const std::shared_ptr<Matrix>& matrix, Events& events, const std::shared_ptr<Assets>& assets);
 
   virtual ~MultiPlayer() noexcept {}
 
@@ -15,26 +19,26 @@ class MultiPlayer final : public Pane, public EventListener,  public network::Li
 
   virtual void Reset() override { got_lines_from_.clear(); }
 
+  virtual void Tick(double delta_time) override;
+
   virtual void Render(double) override;
 
-  void Enable() {
-    if (multiplayer_controller_ != nullptr) {
-      return;
-    }
-    multiplayer_controller_ = std::make_unique<network::MultiPlayerController>(this);
-    multiplayer_controller_->Join();
-  }
+  // The controller is brought up on a thread of its own, the pane shows that it's connecting until it's up
+  void Enable();
 
-  void Disable() {
-    if (!multiplayer_controller_) {
-      return;
-    }
-    multiplayer_controller_.reset();
-    score_board_.clear();
-    players_.clear();
+  void Disable();
+
+  // Connected or connecting, the received packages are handled every frame
+  inline bool IsActive() const { return multiplayer_controller_ || connecting_.valid(); }
+
+  void InvalidateBoards() {
+    std::for_each(score_board_.begin(), score_board_.end(), [](const auto& player) { player->InvalidateBoard(); });
   }
 
   bool CanPressNewGame() const {
+    if (!multiplayer_controller_) {
+      return !enabled_;
+    }
     return std::none_of(score_board_.begin(), score_board_.end(), [](const auto& p) { return p->state() == network::GameState::Playing; });
   }
 
@@ -42,7 +46,7 @@ class MultiPlayer final : public Pane, public EventListener,  public network::Li
     return std::none_of(score_board_.begin(), score_board_.end(), [](const auto& p) { return p->state() == network::GameState::Waiting; });
   }
 
-  void NewGame() { multiplayer_controller_->NewGame(); }
+  void NewGame();
 
   void DebugSend(int lines) {
     if (!multiplayer_controller_) {
@@ -51,7 +55,7 @@ class MultiPlayer final : public Pane, public EventListener,  public network::Li
     multiplayer_controller_->SendUpdate(lines);
   }
 
-  const std::string& our_host_name() const { return multiplayer_controller_->our_host_name(); }
+  std::string our_host_name() const { return network::GetHostName(); }
 
  protected:
   virtual bool GotJoin(const std::string& name, uint64_t host_id) override;
@@ -66,6 +70,12 @@ class MultiPlayer final : public Pane, public EventListener,  public network::Li
 
   virtual void GotProgressUpdate(uint64_t host_id, int lines, int score, int level, const network::MatrixState&) override;
 
+  virtual void GotProgressUpdate(uint64_t host_id, int lines, int score, int level, const network::PieceState&) override;
+
+  virtual void GotSeed(uint64_t host_id, uint64_t seed) override;
+
+  virtual void GotInput(uint64_t host_id, const network::InputEvent& input) override;
+
   virtual void GotLines(uint64_t host_id, int lines) override;
 
   virtual void GotPlayerKnockedOut(uint64_t host_id) override;
@@ -73,20 +83,62 @@ class MultiPlayer final : public Pane, public EventListener,  public network::Li
 private:
   inline bool IsUs(uint64_t host_id) const { return multiplayer_controller_->IsUs(host_id); }
 
+  // Nullptr for a host that was refused when it joined, the room was full
+  Player::Ptr FindPlayer(uint64_t host_id) const {
+    auto it = players_.find(host_id);
+
+    return (it == players_.end()) ? nullptr : it->second;
+  }
+
+  void PollConnection();
+
+  void Disconnect();
+
+  void SetStatus(const std::string& status);
+
+  void SetTimerText(size_t seconds, Color color = Color::White) {
+    const SDL_Rect rc = { kMatrixStartX, 5, timer_atlas_.Width(timer_text_), timer_atlas_.height() };
+
+    Damage(rc);
+    timer_text_ = timer_.FormatTime(seconds);
+    timer_color_ = color;
+    Damage({ kMatrixStartX, 5, timer_atlas_.Width(timer_text_), timer_atlas_.height() });
+  }
+
   void SortScoreBoard();
 
+  void SendInputStream();
+
+  void SendProgressUpdate();
+
+  void UpdateConnectionQuality();
+
   std::shared_ptr<Matrix> matrix_;
   Events& events_;
   utility::Timer timer_;
+  GlyphAtlas& timer_atlas_;
+  std::string timer_text_;
+  Color timer_color_ = Color::White;
   network::GameState game_state_ = network::GameState::None;
   std::vector<Player::Ptr> score_board_;
   std::deque<uint64_t> got_lines_from_;
   std::unordered_map<uint64_t, Player::Ptr> players_;
   std::unique_ptr<network::MultiPlayerController> multiplayer_controller_;
+  std::future<std::unique_ptr<network::MultiPlayerController>> connecting_;
+  bool enabled_ = false;
+  UniqueTexturePtr status_texture_;
+  SDL_Rect status_texture_rc_;
   Accumlator accumulator_;
-  double ticks_progess_update_ = 0.0;
-  UniqueTexturePtr timer_texture_;
-  SDL_Rect timer_texture_rc_;
+  network::ProgressScheduler progress_scheduler_;
+  double clock_ = 0.0;
+  double connection_quality_updated_at_ = 0.0;
+  bool input_stream_ = false;
+  bool refused_ = false;
+  uint32_t operations_sent_ = 0;
+  uint32_t operations_since_hash_ = 0;
+  int progress_updates_sent_ = 0;
+  int64_t game_start_time_ = 0;
+  std::unordered_map<uint64_t, std::unique_ptr<OpponentSimulation>> simulations_;
   CampaignType campaign_type_ = CampaignType::None;
   int start_level_ = 1;
 };
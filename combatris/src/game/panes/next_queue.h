@@ -4,15 +4,33 @@
 
 class NextQueue final : public TextPane {
  public:
-  NextQueue(SDL_Renderer* renderer, const std::shared_ptr<TetrominoGenerator>& tetromino_generator, const std::shared_ptr<Assets>& assets)
+  NextQueue(Renderer* renderer, const std::shared_ptr<TetrominoGenerator>& tetromino_generator, const std::shared_ptr<Assets>& assets)
       : TextPane(renderer,  kMatrixEndX + kMinoWidth + kSpace,
                  kMatrixStartY - kMinoHeight, "NEXT", assets), tetromino_generator_(tetromino_generator) {
     SetCaptionOrientation(TextPane::Orientation::Left);
   }
 
-  void Show() { hide_pieces_ = false; }
+  void Show() {
+    hide_pieces_ = false;
+    DamageBox();
+  }
+
+  void Hide() {
+    hide_pieces_ = true;
+    DamageBox();
+  }
 
-  void Hide() { hide_pieces_ = true; }
+  // The queue is changed by the generator, the pieces shown are compared with the front of the queue
+  virtual void Tick(double) override {
+    for (size_t i = 0; i < shown_.size(); ++i) {
+      const auto type = tetromino_generator_->Peek(i);
+
+      if (type != shown_[i]) {
+        shown_[i] = type;
+        DamageBox();
+      }
+    }
+  }
 
   virtual void Render(double delta_time) override {
     TextPane::Render(delta_time);
@@ -30,5 +48,6 @@ class NextQueue final : public TextPane {
 
  private:
   bool hide_pieces_ = true;
+  std::array<Tetromino::Type, 3> shown_ = {};
   std::shared_ptr<TetrominoGenerator> tetromino_generator_;
 };
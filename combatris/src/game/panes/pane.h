@@ -7,29 +7,44 @@
 
 class Pane : public PaneInterface {
  public:
-  Pane(SDL_Renderer* renderer, int x, int y, const std::shared_ptr<Assets>& assets) : renderer_(renderer), x_(x), y_(y), assets_(assets) {}
+  Pane(Renderer* renderer, int x, int y, const std::shared_ptr<Assets>& assets) : renderer_(renderer), x_(x), y_(y), assets_(assets) {}
 
   Pane(const Pane&) = delete;
 
-  static void SetDrawColor(SDL_Renderer* renderer, const Color& c) {
+  static void SetDrawColor(Renderer* renderer, const Color& c) {
     auto color = GetColor(c);
 
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+    renderer->SetDrawColor(color.r, color.g, color.b, color.a);
   }
 
-  static void FillRect(SDL_Renderer* renderer, int x, int y, int w, int h) {
+  static void FillRect(Renderer* renderer, int x, int y, int w, int h) {
     SDL_Rect rc = { x, y, w, h };
-    SDL_RenderFillRect(renderer, &rc);
+    renderer->FillRect(&rc);
   }
 
-  static void RenderCopy(SDL_Renderer* renderer, SDL_Texture *texture, int x, int y, int w, int h) {
+  static void RenderCopy(Renderer* renderer, Texture *texture, int x, int y, int w, int h) {
     SDL_Rect rc = { x, y, w, h };
-    SDL_RenderCopy(renderer, texture, nullptr, &rc);
+    renderer->Copy(texture, nullptr, &rc);
   }
 
-  static void RenderCopy(SDL_Renderer* renderer, SDL_Texture *texture, const SDL_Rect& rc) { SDL_RenderCopy(renderer, texture, nullptr, &rc); }
+  static void RenderCopy(Renderer* renderer, Texture *texture, const SDL_Rect& rc) { renderer->Copy(texture, nullptr, &rc); }
+
+  virtual SDL_Rect TakeDamage() override {
+    SDL_Rect damage = { 0, 0, 0, 0 };
+
+    std::swap(damage, damage_);
+
+    return damage;
+  }
 
  protected:
+  // The area is redrawn before the next frame
+  void Damage(const SDL_Rect& rc) {
+    const auto damage = damage_;
+
+    SDL_UnionRect(&damage, &rc, &damage_);
+  }
+
   void RenderText(int x, int y, const Font& font, const std::string& text, Color text_color) const {
     ::RenderText(renderer_, x_ + x, y_ + y, assets_->GetFont(font), text, text_color);
   }
@@ -38,14 +53,17 @@ class Pane : public PaneInterface {
 
   void FillRect(int x, int y, int w, int h) const { FillRect(renderer_, x_ + x, y_ + y, w, h); }
 
-  void RenderCopy(SDL_Texture* texture, int x, int y, int w, int h) const { RenderCopy(renderer_, texture, x_ + x, y_ + y, w, h); }
+  void RenderCopy(Texture* texture, int x, int y, int w, int h) const { RenderCopy(renderer_, texture, x_ + x, y_ + y, w, h); }
 
-  void RenderCopy(SDL_Texture* texture, SDL_Rect& rc) { SDL_RenderCopy(renderer_, texture, nullptr, &rc); }
+  void RenderCopy(Texture* texture, SDL_Rect& rc) { renderer_->Copy(texture, nullptr, &rc); }
 
-  SDL_Renderer* renderer_;
+  Renderer* renderer_;
   int x_;
   int y_;
   const std::shared_ptr<Assets>& assets_;
+
+ private:
+  SDL_Rect damage_ = { 0, 0, 0, 0 };
 };
 
 class TextPane : public Pane {
@@ -57,11 +75,11 @@ class TextPane : public Pane {
   static const int kBoxInteriorWidth = 138;
   static const int kBoxInteriorHeight = 74;
 
-  TextPane(SDL_Renderer* renderer, int x, int y, const std::string& text, const std::shared_ptr<Assets>& assets) : Pane(renderer, x, y, assets) {
+  TextPane(Renderer* renderer, int x, int y, const std::string& text, const std::shared_ptr<Assets>& assets) : Pane(renderer, x, y, assets) {
     std::tie(caption_texture_, caption_width_, caption_height_) = CreateTextureFromText(renderer_, assets_->GetFont(Bold25), text, Color::White);
   }
 
-  TextPane(SDL_Renderer* renderer, int x, int y, const std::shared_ptr<Assets>& assets) : Pane(renderer, x, y, assets) {}
+  TextPane(Renderer* renderer, int x, int y, const std::shared_ptr<Assets>& assets) : Pane(renderer, x, y, assets) {}
 
   void SetCaptionOrientation(Orientation orientation) { orientation_ = orientation; }
 
@@ -71,29 +89,33 @@ class TextPane : public Pane {
     lines_.resize(1);
     auto& line = lines_[0];
 
-    std::tie(line.texture_, line.w_, line.h_) = CreateTextureFromText(renderer_, assets_->GetFont(font), text, color);
-
+    line.Set(assets_->GetGlyphAtlas(font), text, color);
     line.x_ = ((kBoxWidth - line.w_) / 2);
     line.y_ = ((kBoxHeight - line.h_) / 2) + (caption_height_ + 5);
+    DamageBox();
   }
 
-  void ClearBox() { lines_.clear(); }
+  void ClearBox() {
+    lines_.clear();
+    DamageBox();
+  }
 
 
   void SetCenteredText(const std::string& text1, Color color1, const std::string& text2, Color color2) {
     lines_.resize(2);
     auto& line1 = lines_[0];
-    std::tie(line1.texture_, line1.w_, line1.h_) = CreateTextureFromText(renderer_, assets_->GetFont(Bold25), text1, color1);
+    line1.Set(assets_->GetGlyphAtlas(Bold25), text1, color1);
     line1.x_ = ((kBoxWidth - line1.w_) / 2);
     line1.y_ = (caption_height_ + 15);
 
     auto& line2 = lines_[1];
-    std::tie(line2.texture_, line2.w_, line2.h_) = CreateTextureFromText(renderer_, assets_->GetFont(Bold25), text2, color2);
+    line2.Set(assets_->GetGlyphAtlas(Bold25), text2, color2);
     line2.x_ = ((kBoxWidth - line2.w_) / 2);
     line2.y_ = line1.h_ + 10 + (caption_height_ + 5);
+    DamageBox();
   }
 
-  virtual void Render(double) override {
+  virtual void RenderBackground() override {
     if (caption_texture_) {
       if (Orientation::Right == orientation_) {
         RenderCopy(caption_texture_.get(), kBoxWidth - caption_width_, 0, caption_width_, caption_height_);
@@ -105,18 +127,32 @@ class TextPane : public Pane {
     FillRect(0, 5 + caption_height_, kBoxWidth, kBoxHeight);
     SetDrawColor(Color::Black);
     FillRect(5, 10 + caption_height_, kBoxInteriorWidth, kBoxInteriorHeight);
+  }
+
+  virtual void Render(double) override {
     for (const auto& line : lines_) {
-      RenderCopy(line.texture_.get(), line.x_, line.y_, line.w_, line.h_);
+      line.atlas_->Render(x_ + line.x_, y_ + line.y_, line.text_, line.color_);
     }
   }
 
  protected:
+  void DamageBox() { Damage({ x_, y_ + caption_height_ + 5, kBoxWidth, kBoxHeight }); }
+
   struct TextLine {
+    void Set(GlyphAtlas& atlas, const std::string& text, Color color) {
+      atlas_ = &atlas;
+      text_ = text;
+      color_ = color;
+      w_ = atlas.Width(text);
+      h_ = atlas.height();
+    }
     int x_ = 0;
     int y_ = 0;
     int w_ = 0;
     int h_ = 0;
-    UniqueTexturePtr texture_ = nullptr;
+    GlyphAtlas* atlas_ = nullptr;
+    std::string text_;
+    Color color_ = Color::White;
   };
   std::vector<TextLine> lines_;
   int caption_width_ = 0;
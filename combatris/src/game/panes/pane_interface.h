@@ -1,8 +1,16 @@
 #pragma once
 
+#include <SDL.h>
+
 class PaneInterface {
  public:
   virtual ~PaneInterface() noexcept {}
+  // Called every frame, whether the pane is redrawn or not
+  virtual void Tick(double) {}
   virtual void Render(double) = 0;
+  // The parts that do not change, drawn into the background layer of the campaign
+  virtual void RenderBackground() {}
+  // The area that changed since the last call, empty if the pane looks the same
+  virtual SDL_Rect TakeDamage() = 0;
   virtual void Reset() = 0;
 };
@@ -23,6 +23,13 @@ const SDL_Rect kLinesSentFieldRc = { kX + 98, kY + 112, 122, 24 };
 const SDL_Rect kLinesCaptionFieldRc = { kX + 98, kY + 136, 122, 24 };
 const SDL_Rect kLinesFieldRc = { kX + 98, kY + 158, 122, 24 };
 const SDL_Rect kMatrixFieldRc = { kX + kMatrixStartPosX, kY + kMatrixStartPosY, 84 + kPlayerMinoWidth, 166 + kPlayerMinoHeight };
+const int kBoardWidth = (kVisibleCols + 2) * kPlayerMinoWidth;
+const int kBoardHeight = (kVisibleRows + 2) * kPlayerMinoHeight;
+
+const std::vector<SDL_Rect> kBoxRcs = {
+  kNameFieldRc, kStateFieldRc, kScoreCaptionFieldRc, kLevelCaptionFieldRc, kMatrixFieldRc, kKOCaptionFieldRc, kKOFieldRc,
+  kLinesSentCaptionFieldRc, kLinesSentFieldRc, kLinesCaptionFieldRc, kLinesFieldRc
+};
 
 const Font kTextFont(Font::Typeface::Cabin, Font::Emphasis::Bold, 15);
 
@@ -53,7 +60,7 @@ const Player::MatrixType kEmptyMatrix {
   }
 };
 
-using ID = Player::TextureID;
+using ID = Player::TextID;
 
 struct Field {
   Field(ID id, const std::string& name, const SDL_Rect& rc, Color color = Color::SteelGray)
@@ -83,11 +90,6 @@ inline SDL_Rect* AddBorder(SDL_Rect& tmp, const SDL_Rect& rc) {
   return &tmp;
 }
 
-inline SDL_Rect* InsideBox(SDL_Rect& tmp, const SDL_Rect& rc, int w, int h) {
-  tmp = { rc.x + (kLineThinkness * 2), rc.y  + kLineThinkness, w, h};
-  return &tmp;
-}
-
 inline const SDL_Rect& AddOffset(SDL_Rect& tmp, int x_offset, int y_offset, const SDL_Rect& rc) {
   tmp = { rc.x + x_offset, rc.y + y_offset, rc.w, rc.h };
   return tmp;
@@ -97,29 +99,23 @@ std::string IntToString(int v) { return std::to_string(v); }
 
 } // namespace
 
-Player::Player(SDL_Renderer* renderer, const std::string& name, uint64_t host_id, const std::shared_ptr<Assets>& assets)
-    : renderer_(renderer), name_(name), host_id_(host_id), assets_(assets), tetrominos_(assets_->GetTetrominos()) {
+Player::Player(Renderer* renderer, const std::string& name, uint64_t host_id, const std::shared_ptr<Assets>& assets)
+    : renderer_(renderer), name_(name), host_id_(host_id), assets_(assets), atlas_(assets_->GetGlyphAtlas(kTextFont)),
+      mino_atlas_(assets_->GetMinoAtlas()) {
   for (const auto& field : kFields) {
-    auto [texture, w, h] = CreateTextureFromText(renderer_, assets_->GetFont(kTextFont), field.name_, field.color_);
-
-    textures_.insert(std::make_pair(field.id_, std::make_shared<Texture>(std::move(texture), w, h, field.rc_)));
+    texts_.emplace(field.id_, Text(field.name_, field.color_, field.rc_));
   }
-  auto [texture, w, h] = CreateTextureFromText(renderer_, assets_->GetFont(kTextFont), name_, Color::Yellow);
-
-  textures_.insert(std::make_pair(ID::Name, std::make_shared<Texture>(std::move(texture), w, h, kNameFieldRc)));
+  texts_.emplace(ID::Name, Text(name_, Color::Yellow, kNameFieldRc));
   matrix_ = kEmptyMatrix;
+  changed_ = true;
 }
 
-int Player::Update(Player::TextureID id, int new_value, int old_value, Function to_string, bool set_to_zero) {
+int Player::Update(Player::TextID id, int new_value, int old_value, Function to_string, bool set_to_zero) {
   if (!set_to_zero && (0 == new_value || new_value == old_value)) {
     return old_value;
   }
-  auto& stat = textures_.at(id);
-
-  auto txt = (-1 == new_value) ? "-" : to_string(new_value);
-  auto [texture, w, h] = CreateTextureFromText(renderer_, assets_->GetFont(kTextFont), txt, Color::Yellow);
-
-  stat->Set(std::move(texture), w, h);
+  texts_.at(id).text_ = (-1 == new_value) ? "-" : to_string(new_value);
+  changed_ = true;
 
   return new_value;
 }
@@ -145,6 +141,7 @@ void Player::SetMatrixState(const network::MatrixState& state) {
       i++;
     }
   }
+  changed_ = true;
 }
 
 void Player::SetState(GameState state, bool set_to_zero) {
@@ -172,47 +169,81 @@ void Player::Reset() {
   matrix_ = kEmptyMatrix;
 }
 
-void Player::Render(int x_offset, int y_offset, bool is_my_status) const {
-  Pane::SetDrawColor(renderer_, (is_my_status) ? Color::Green : Color::White);
-  Pane::FillRect(renderer_, kX + x_offset, kY + y_offset, kBoxWidth, kBoxHeight);
-  Pane::SetDrawColor(renderer_, Color::Black);
-  SDL_Rect tmp;
-
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kNameFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kStateFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kScoreCaptionFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kLevelCaptionFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kMatrixFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kKOCaptionFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kKOFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kLinesSentCaptionFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kLinesSentFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kLinesCaptionFieldRc)));
-  SDL_RenderFillRect(renderer_, AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, kLinesFieldRc)));
-
-  for (const auto& it : textures_) {
-    const auto& field = it.second;
-
-    SDL_RenderCopy(renderer_, it.second->texture_.get(), nullptr,
-                   &AddOffset(tmp, x_offset, y_offset, *InsideBox(tmp, field->rc_, field->w_, field->h_)));
+void Player::UpdateBoard() {
+  if (!board_) {
+    board_ = renderer_->CreateTexture(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, kBoardWidth, kBoardHeight);
+    if (!board_) {
+      return;
+    }
+    renderer_->SetTextureBlendMode(board_.get(), SDL_BLENDMODE_BLEND);
+    // No cell has this id, every cell is drawn
+    for (auto& row : board_matrix_) {
+      row.fill(0xFF);
+    }
   }
-  int y_pos = 0;
-  int x_pos = 0;
+  std::vector<SDL_Rect> changed;
 
   for (int row = 0; row < static_cast<int>(matrix_.size()); ++row) {
-    x_pos = 0;
+    for (int col = 0; col < static_cast<int>(matrix_[row].size()); ++col) {
+      if (matrix_[row][col] != board_matrix_[row][col]) {
+        changed.push_back({ col * kPlayerMinoWidth, row * kPlayerMinoHeight, kPlayerMinoWidth, kPlayerMinoHeight });
+      }
+    }
+  }
+  if (changed.empty()) {
+    return;
+  }
+  auto target = renderer_->GetTarget();
+
+  renderer_->SetTarget(board_.get());
+  // The changed cells are cleared to transparent, the box behind the board shows through the empty ones
+  renderer_->SetDrawColor(0, 0, 0, 0);
+  renderer_->FillRects(changed.data(), static_cast<int>(changed.size()));
+  for (const auto& rc : changed) {
+    const auto id = matrix_[rc.y / kPlayerMinoHeight][rc.x / kPlayerMinoWidth];
 
+    if (kEmptyID != id) {
+      mino_atlas_.Add(rc.x, rc.y, kPlayerMinoWidth, kPlayerMinoHeight, id);
+    }
+  }
+  mino_atlas_.Flush();
+  renderer_->SetTarget(target);
+  board_matrix_ = matrix_;
+}
+
+void Player::RenderMatrix(int x, int y) const {
+  for (int row = 0; row < static_cast<int>(matrix_.size()); ++row) {
     for (int col = 0; col < static_cast<int>(matrix_[row].size()); ++col) {
       const auto id = matrix_[row][col];
 
-      if (kEmptyID == id) {
-        x_pos += kPlayerMinoWidth;
-        continue;
+      if (kEmptyID != id) {
+        mino_atlas_.Add(x + (col * kPlayerMinoWidth), y + (row * kPlayerMinoHeight), kPlayerMinoWidth, kPlayerMinoHeight, id);
       }
-      RenderMino(renderer_, kX + kMatrixStartPosX + x_pos + x_offset, kY + kMatrixStartPosY + y_pos + y_offset,
-                 kPlayerMinoWidth, kPlayerMinoHeight, tetrominos_[id - 1]->texture());
-      x_pos += kPlayerMinoWidth;
     }
-    y_pos += kPlayerMinoHeight;
   }
 }
+
+void Player::Render(int x_offset, int y_offset, bool is_my_status) const {
+  const SDL_Rect box_rc = { kX + x_offset, kY + y_offset, kBoxWidth, kBoxHeight };
+  const SDL_Rect board_rc = { kX + kMatrixStartPosX + x_offset, kY + kMatrixStartPosY + y_offset, kBoardWidth, kBoardHeight };
+  const auto black = GetColor(Color::Black);
+  SDL_Rect tmp;
+
+  // The boxes are drawn in one batch, then the board and the text on top of them. Without render targets the minos of
+  // the board are drawn with the boxes.
+  mino_atlas_.AddRect(box_rc, GetColor((is_my_status) ? Color::Green : Color::White));
+  for (const auto& rc : kBoxRcs) {
+    mino_atlas_.AddRect(*AddBorder(tmp, AddOffset(tmp, x_offset, y_offset, rc)), black);
+  }
+  if (!board_) {
+    RenderMatrix(board_rc.x, board_rc.y);
+  }
+  mino_atlas_.Flush();
+  if (board_) {
+    renderer_->Copy(board_.get(), nullptr, &board_rc);
+  }
+  for (const auto& [id, text] : texts_) {
+    atlas_.Add(text.rc_.x + (kLineThinkness * 2) + x_offset, text.rc_.y + kLineThinkness + y_offset, text.text_, text.color_);
+  }
+  atlas_.Flush();
+}
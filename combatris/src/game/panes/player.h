@@ -4,6 +4,7 @@
 #include "network/multiplayer_controller.h"
 
 #include <functional>
+#include <utility>
 
 namespace {
 
@@ -14,13 +15,13 @@ const int kY = kMatrixStartY - kMinoHeight;
 
 class Player final {
  public:
-  enum TextureID { Name, State, ScoreCaption, Score, KOCaption, KO, LevelCaption, Level, LinesCaption, Lines, LinesSentCaption, LinesSent};
+  enum TextID { Name, State, ScoreCaption, Score, KOCaption, KO, LevelCaption, Level, LinesCaption, Lines, LinesSentCaption, LinesSent};
   using Ptr = std::shared_ptr<Player>;
   using GameState = network::GameState;
   using Function = std::function<std::string(int)>;
   using MatrixType = std::array<std::array<uint8_t, kVisibleCols + 2>, kVisibleRows + 2>;
 
-  Player(SDL_Renderer* renderer, const std::string& name, uint64_t host_id, const std::shared_ptr<Assets>& assets);
+  Player(Renderer* renderer, const std::string& name, uint64_t host_id, const std::shared_ptr<Assets>& assets);
 
   Player(const Player&) = delete;
 
@@ -50,30 +51,40 @@ class Player final {
 
   void Reset();
 
+  // True once after anything drawn by Render has changed
+  bool TakeChanged() { return std::exchange(changed_, false); }
+
+  // Redraws the cells of the board texture that changed since the last call, not while a frame is drawn as it
+  // changes the render target
+  void UpdateBoard();
+
+  // The board texture is created again by the next UpdateBoard, render targets lose their content when reset
+  void InvalidateBoard() {
+    board_.reset();
+    changed_ = true;
+  }
+
   void Render(int x_offset, int y_offset, bool is_my_status) const;
 
  private:
-  struct Texture {
-    Texture(UniqueTexturePtr&& texture, int w, int h, SDL_Rect rc)
-        : texture_(std::move(texture)), w_(w), h_(h), rc_(rc) {}
-
-    void Set(UniqueTexturePtr&& texture, int w, int h) {
-      texture_ = std::move(texture);
-      w_ = w;
-      h_ = h;
-    }
-    UniqueTexturePtr texture_ = nullptr;
-    int w_;
-    int h_;
+  struct Text {
+    Text(const std::string& text, Color color, SDL_Rect rc) : text_(text), color_(color), rc_(rc) {}
+
+    std::string text_;
+    Color color_;
     SDL_Rect rc_;
   };
 
-  int Update(Player::TextureID id, int new_value, int old_value, Function to_string, bool set_to_zero = false);
+  int Update(Player::TextID id, int new_value, int old_value, Function to_string, bool set_to_zero = false);
+
+  void RenderMatrix(int x, int y) const;
 
-  SDL_Renderer* renderer_;
+  Renderer* renderer_;
   std::string name_;
   uint64_t host_id_;
   const std::shared_ptr<Assets>& assets_;
+  GlyphAtlas& atlas_;
+  MinoAtlas& mino_atlas_;
   int lines_ = 0;
   int lines_sent_ = 0;
   int score_ = 0;
@@ -81,6 +92,8 @@ class Player final {
   int ko_ = 0;
   GameState state_ = GameState::None;
   MatrixType matrix_;
-  std::vector<std::shared_ptr<const Tetromino>> tetrominos_;
-  std::unordered_map<TextureID, std::shared_ptr<Texture>> textures_;
+  bool changed_ = true;
+  UniqueTexturePtr board_;
+  MatrixType board_matrix_; // As drawn on the board texture
+  std::unordered_map<TextID, Text> texts_;
 };
@@ -51,9 +51,13 @@ void Scoring::Update(const Event& event) {
 }
 
 void Scoring::DisplayScore(int score) {
-  std::tie(score_texture_, rc_.w, rc_.h) = CreateTextureFromText(renderer_, assets_->GetFont(ObelixPro40), std::to_string(score), Color::Yellow);
+  Damage(rc_);
+  score_text_ = std::to_string(score);
+  rc_.w = score_atlas_.Width(score_text_);
+  rc_.h = score_atlas_.height();
   rc_.x = x_ - rc_.w;
   rc_.y = y_ - rc_.h;
+  Damage(rc_);
 }
 
 void Scoring::UpdateEvents(int score, ComboType combo_type, int lines_to_send, int lines_to_clear, const Event& event) {
@@ -6,7 +6,7 @@ class Scoring final : public Pane, public EventListener {
  public:
   enum class LinesClearedMode { Normal, Marathon };
 
-  Scoring(SDL_Renderer* renderer, const std::shared_ptr<Assets>& assets, Events& events) : Pane(renderer, kMatrixEndX + kMinoWidth, kMatrixStartY - kMinoHeight, assets), events_(events) { Reset(); }
+  Scoring(Renderer* renderer, const std::shared_ptr<Assets>& assets, Events& events) : Pane(renderer, kMatrixEndX + kMinoWidth, kMatrixStartY - kMinoHeight, assets), events_(events), score_atlas_(assets->GetGlyphAtlas(ObelixPro40)) { Reset(); }
 
   virtual void Reset() override {
     level_ = start_level_;
@@ -19,7 +19,7 @@ class Scoring final : public Pane, public EventListener {
 
   virtual void Update(const Event& event) override;
 
-  virtual void Render(double) override { RenderCopy(score_texture_.get(), rc_); }
+  virtual void Render(double) override { score_atlas_.Render(rc_.x, rc_.y, score_text_, Color::Yellow); }
 
  protected:
   void DisplayScore(int score);
@@ -33,8 +33,9 @@ class Scoring final : public Pane, public EventListener {
   int score_ = 0;
   int combo_counter_ = 0;
   int b2b_counter_ = 0;
-  SDL_Rect rc_;
-  UniqueTexturePtr score_texture_ = nullptr;
+  GlyphAtlas& score_atlas_;
+  SDL_Rect rc_ = { 0, 0, 0, 0 };
+  std::string score_text_;
   CampaignRuleType rule_type_ = CampaignRuleType::Normal;
   int level_ = 1;
   int start_level_ = 1;
@@ -6,7 +6,7 @@
 class TotalLines final : public TextPane, public EventListener {
  public:
   // 578
-  TotalLines(SDL_Renderer* renderer, int offset, const std::shared_ptr<Assets>& assets)
+  TotalLines(Renderer* renderer, int offset, const std::shared_ptr<Assets>& assets)
        : TextPane(renderer, kMatrixStartX - kMinoWidth - (kBoxWidth + kSpace),
                   (kMatrixStartY - kMinoHeight) + offset, "LINES", assets) { Reset(); }
 
@@ -1,11 +1,12 @@
 #include "game/tetrion.h"
 
-#include <iostream>
-
 namespace {
 
 const int kSinglePlayerCountDown = 3;
 const int kMultiPlayerCountDown = 9;
+// Gravity and lock delay are advanced in fixed ticks, a long frame is cut to kMaxFrameTime
+const double kTickTime = 1.0 / 240.0;
+const double kMaxFrameTime = 0.25;
 
 bool RenderAnimations(std::deque<std::shared_ptr<Animation>>& animations, double delta_time, Events& events) {
   for (auto it = animations.begin(); it != animations.end();) {
@@ -34,18 +35,7 @@ bool IsAnimationActive(std::deque<std::shared_ptr<Animation>>& animations) {
 
 } // namespace
 
-Tetrion::Tetrion() : events_() {
-  window_ = SDL_CreateWindow("", SDL_WINDOWPOS_UNDEFINED,
-                             SDL_WINDOWPOS_UNDEFINED, kWidth, kHeight, SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
-  if (nullptr == window_) {
-    std::cout << "Failed to create window : " << SDL_GetError() << std::endl;
-    exit(-1);
-  }
-  renderer_ = SDL_CreateRenderer(window_, -1, SDL_RENDERER_ACCELERATED);
-  if (nullptr == renderer_) {
-    std::cout << "Failed to create renderer : " << SDL_GetError() << std::endl;
-    exit(-1);
-  }
+Tetrion::Tetrion(Renderer* renderer) : renderer_(renderer), events_() {
   assets_ = std::make_shared<Assets>(renderer_);
   matrix_ = std::make_shared<Matrix>(renderer_, assets_->GetTetrominos());
   campaign_ = std::make_shared<Campaign>(renderer_, events_, assets_, matrix_);
@@ -54,13 +44,7 @@ Tetrion::Tetrion() : events_() {
   tetromino_generator_ = campaign_->GetTetrominoGenerator();
   combatris_menu_ = std::make_shared<CombatrisMenu>(events_);
   AddAnimation<SplashScreenAnimation>(renderer_, combatris_menu_, assets_);
-  campaign_->Set(window_, CampaignType::Tetris);
-  SDL_RaiseWindow(window_);
-}
-
-Tetrion::~Tetrion() noexcept {
-  SDL_DestroyRenderer(renderer_);
-  SDL_DestroyWindow(window_);
+  campaign_->Set(CampaignType::Tetris);
 }
 
 void Tetrion::HandleMenu(Controls control_pressed) {
@@ -156,7 +140,7 @@ void Tetrion::EventHandler(Events& events) {
 
   switch (event.type()) {
     case Event::Type::MenuSetCampaign:
-      campaign_->Set(window_, ToCampaignType(event.value_));
+      campaign_->Set(ToCampaignType(event.value_));
       break;
     case Event::Type::Pause:
       campaign_->Pause();
@@ -223,7 +207,8 @@ void Tetrion::EventHandler(Events& events) {
       break;
     case Event::Type::MultiplayerResetCountDown:
       RemoveAnimation<CountDownAnimation>(animations_);
-      AddAnimation<CountDownAnimation>(renderer_, assets_, kMultiPlayerCountDown, Event::Type::MultiplayerStartGame);
+      AddAnimation<CountDownAnimation>(renderer_, assets_, kMultiPlayerCountDown, Event::Type::MultiplayerStartGame,
+                                       event.value_ / 1000.0);
       break;
     case Event::Type::BattleGotLines:
       if (!tetromino_in_play_) {
@@ -240,20 +225,34 @@ void Tetrion::EventHandler(Events& events) {
 }
 
 void Tetrion::Render(double delta_time) {
-  SDL_RenderClear(renderer_);
+  const bool changed = campaign_->UpdateFrame(delta_time);
+
+  // One more frame is presented after the last animation has ended to remove it
+  if (!changed && animations_.empty() && !animations_active_) {
+    return;
+  }
+  animations_active_ = !animations_.empty();
+  renderer_->Clear();
   campaign_->Render(delta_time);
   RenderAnimations(animations_, delta_time, events_);
 
-  SDL_RenderPresent(renderer_);
+  renderer_->Present();
 }
 
 void Tetrion::Update(double delta_time) {
   EventHandler(events_);
   if (!game_paused_) {
-    if (tetromino_in_play_ && tetromino_in_play_->Down(delta_time) == TetrominoSprite::State::Commited) {
-      tetromino_in_play_.reset();
-      events_.Push(Event::Type::NextTetromino);
+    simulation_time_ += std::min(delta_time, kMaxFrameTime);
+    while (tetromino_in_play_ && simulation_time_ >= kTickTime) {
+      simulation_time_ -= kTickTime;
+      if (tetromino_in_play_->Down(kTickTime) == TetrominoSprite::State::Commited) {
+        tetromino_in_play_.reset();
+        events_.Push(Event::Type::NextTetromino);
+      }
+    }
+    if (!tetromino_in_play_) {
+      simulation_time_ = 0.0;
     }
   }
-  Render(delta_time);
+  campaign_->Tick(delta_time);
 }
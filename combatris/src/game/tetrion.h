@@ -22,14 +22,13 @@ class Tetrion final {
     Down = SoftDrop
   };
 
-  Tetrion();
+  // The game is run on the simulation thread, what it draws is recorded by the renderer and drawn by the render thread
+  explicit Tetrion(Renderer* renderer);
 
   Tetrion(const Tetrion&) = delete;
 
   Tetrion(const Tetrion&&) = delete;
 
-  ~Tetrion() noexcept;
-
   void NewGame() { events_.Push(Event::Type::NewGame); }
 
   void Pause() {
@@ -47,9 +46,24 @@ class Tetrion final {
 
   void ResetCountDown();
 
+  inline void WindowChanged() { campaign_->InvalidateBackground(); }
+
   void GameControl(Controls control_pressed, int lines = 0);
 
-  void Update(double delta_timer);
+  // Handles the events and advances the simulation, nothing is drawn
+  void Update(double delta_time);
+
+  void Render(double delta_time);
+
+  // The render thread has picked up the last frame, a frame drawn before it has would be dropped
+  bool CanRender() const { return renderer_->CanPresent(); }
+
+  // No piece falls, no event is queued, the animations shown are still and no multiplayer session is running. The
+  // panes are ticked in Update, so a session would otherwise be handled at the idle frame rate.
+  bool IsIdle() const {
+    return events_.IsEmpty() && (game_paused_ || !tetromino_in_play_) && !multi_player_->IsActive() &&
+           std::all_of(animations_.begin(), animations_.end(), [](const auto& animation) { return animation->IsStill(); });
+  }
 
  protected:
   template<class T, class ...Args>
@@ -61,15 +75,13 @@ class Tetrion final {
 
   void EventHandler(Events& events);
 
-  void Render(double delta_timer);
-
  private:
-  SDL_Window* window_ = nullptr;
-  SDL_Renderer* renderer_ = nullptr;
+  Renderer* renderer_;
   std::shared_ptr<TetrominoSprite> tetromino_in_play_;
 
   Events events_;
   bool game_paused_ = false;
+  double simulation_time_ = 0.0; // Not yet simulated
   bool unpause_pressed_ = false;
   std::shared_ptr<Assets> assets_;
   std::shared_ptr<Matrix> matrix_;
@@ -78,5 +90,6 @@ class Tetrion final {
   std::shared_ptr<MultiPlayer> multi_player_;
   std::shared_ptr<TetrominoGenerator> tetromino_generator_;
   std::deque<std::shared_ptr<Animation>> animations_;
+  bool animations_active_ = false;
   std::shared_ptr<CombatrisMenu> combatris_menu_;
 };
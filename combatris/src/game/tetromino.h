@@ -2,7 +2,7 @@
 
 #include "utility/color.h"
 #include "game/coordinates.h"
-#include "game/renderer.h"
+#include "game/mino_atlas.h"
 #include "game/tetromino_rotation_data.h"
 
 #include <memory>
@@ -13,42 +13,42 @@ class Tetromino final {
   enum class Angle { A0, A90, A180, A270 };
   enum class Type { Empty, I, J, L, O, S, T, Z, Solid, Bomb, Border };
 
-  Tetromino(SDL_Renderer *renderer, Type type, SDL_Color color, const std::vector<TetrominoRotationData>& rotations,
-            const std::shared_ptr<SDL_Texture> &texture)
-      : renderer_(renderer), type_(type), color_(color), rotations_(rotations), texture_(texture) {}
+  Tetromino(Type type, SDL_Color color, const std::vector<TetrominoRotationData>& rotations,
+            const std::shared_ptr<MinoAtlas>& atlas)
+      : type_(type), color_(color), rotations_(rotations), atlas_(atlas) {}
 
   Tetromino(const Tetromino&) = delete;
 
   inline Type type() const { return type_; }
 
-  inline SDL_Texture* texture() const { return texture_.get(); }
+  inline MinoAtlas& atlas() const { return *atlas_; }
 
-  inline void Render(int x, int y) const { RenderMino(renderer_, x, y, texture_.get()); }
+  // Single minos are queued in the atlas, the caller flushes the atlas when the layer is done
+  inline void Render(int x, int y) const { atlas_->Add(x, y, static_cast<int>(type_)); }
 
-  inline void Render(const Position& pos) const { RenderMino(renderer_, pos.x(), pos.y(), texture_.get()); }
+  inline void Render(const Position& pos) const { atlas_->Add(pos.x(), pos.y(), static_cast<int>(type_)); }
 
-  inline void RenderGhost(const Position& pos) const { ::RenderGhost(renderer_, pos.x(), pos.y(), color_); }
+  inline void RenderGhost(const Position& pos) const { atlas_->AddGhost(pos.x(), pos.y(), color_); }
 
   const TetrominoRotationData& GetRotationData(Angle angle) const { return rotations_.at(static_cast<size_t>(angle)); }
 
-  void Render(int x, int y, SDL_Texture* texture, Angle angle) const {
+  void Render(int x, int y, Angle angle, uint8_t alpha) const {
     const auto& rotation = rotations_[static_cast<int>(angle)];
 
     for (int row = 0; row < static_cast<int>(rotation.shape_.size()); ++row) {
       auto t_x = x;
       for (int col = 0; col < static_cast<int>(rotation.shape_[row].size()); ++col) {
         const auto& shape = rotation.shape_;
-        const SDL_Rect rc = { t_x, y, kMinoWidth, kMinoHeight };
 
         if (shape[row][col] != 0) {
-          SDL_SetRenderDrawColor(renderer_, 0, 0, 0, 0);
-          SDL_RenderFillRect(renderer_, &rc);
-          RenderMino(renderer_, t_x, y, texture);
+          atlas_->AddRect({ t_x, y, kMinoWidth, kMinoHeight }, { 0, 0, 0, 255 });
+          atlas_->Add(t_x, y, static_cast<int>(type_), alpha);
         }
         t_x += kMinoWidth;
       }
       y += kMinoHeight;
     }
+    atlas_->Flush();
   }
 
   void RenderTetromino(int x, int y) const {
@@ -63,20 +63,20 @@ class Tetromino final {
         const auto& shape = rotation.shape_;
 
         if (shape[row][col] != 0) {
-          RenderMino(renderer_, t_x, y, texture_.get());
+          atlas_->Add(t_x, y, static_cast<int>(type_));
         }
         t_x += kMinoWidth;
       }
       y += kMinoHeight;
     }
+    atlas_->Flush();
   }
 
  private:
-  SDL_Renderer *renderer_;
   Type type_;
   SDL_Color color_;
   std::vector<TetrominoRotationData> rotations_;
-  std::shared_ptr<SDL_Texture> texture_;
+  std::shared_ptr<MinoAtlas> atlas_;
 };
 
 const int kEmptyID = static_cast<int>(Tetromino::Type::Empty);
@@ -34,6 +34,8 @@ class TetrominoGenerator final {
 
   void Put(const Tetromino& tetromino) { tetrominos_queue_.push_front(tetromino.type()); }
 
+  Tetromino::Type Peek(size_t n) const { return tetrominos_queue_.at(n); }
+
   void RenderFromQueue(size_t n, int x, int y) const { assets_->GetTetromino(tetrominos_queue_.at(n))->RenderTetromino(x, y); }
 
  protected:
@@ -71,7 +71,7 @@ void TetrominoSprite::RotateClockwise() {
   if (auto result = TryRotation(tetromino_.type(), pos_, angle_, Rotation::Clockwise)) {
     std::tie(pos_, angle_) = *result;
     rotation_data_ = tetromino_.GetRotationData(angle_);
-    matrix_->Insert(pos_, rotation_data_);
+    matrix_->Insert(tetromino_.type(), angle_, pos_);
     last_move_ = Tetromino::Move::Rotation;
   }
 }
@@ -80,7 +80,7 @@ void TetrominoSprite::RotateCounterClockwise() {
   if (auto result = TryRotation(tetromino_.type(), pos_, angle_, Rotation::CounterClockwise)) {
     std::tie(pos_, angle_) = *result;
     rotation_data_ = tetromino_.GetRotationData(angle_);
-    matrix_->Insert(pos_, rotation_data_);
+    matrix_->Insert(tetromino_.type(), angle_, pos_);
     last_move_ = Tetromino::Move::Rotation;
   }
 }
@@ -111,7 +111,7 @@ void TetrominoSprite::HardDrop() {
 void TetrominoSprite::Left() {
   if (matrix_->IsValid(Position(pos_.row(), pos_.col() - 1), rotation_data_)) {
     pos_.dec_col();
-    matrix_->Insert(pos_, rotation_data_);
+    matrix_->Insert(tetromino_.type(), angle_, pos_);
     last_move_ = Tetromino::Move::Left;
     ResetDelayCounter();
   }
@@ -120,7 +120,7 @@ void TetrominoSprite::Left() {
 void TetrominoSprite::Right() {
   if (matrix_->IsValid(Position(pos_.row(), pos_.col() + 1), rotation_data_)) {
     pos_.inc_col();
-    matrix_->Insert(pos_, rotation_data_);
+    matrix_->Insert(tetromino_.type(), angle_, pos_);
     last_move_ = Tetromino::Move::Right;
     ResetDelayCounter();
   }
@@ -135,7 +135,7 @@ TetrominoSprite::State TetrominoSprite::Down(double delta_time) {
           state_ = State::Commit;
         } else if (matrix_->IsValid(Position(pos_.row() + 1, pos_.col()), rotation_data_)) {
           pos_.inc_row();
-          matrix_->Insert(pos_, rotation_data_);
+          matrix_->Insert(tetromino_.type(), angle_, pos_);
           if (!matrix_->IsValid(Position(pos_.row() + 1, pos_.col()), rotation_data_)) {
             events_.Push(Event::Type::OnFloor, Events::QueueRule::NoDuplicates);
             state_ = State::OnFloor;
@@ -155,7 +155,7 @@ TetrominoSprite::State TetrominoSprite::Down(double delta_time) {
       }
       break;
     case State::Commit: {
-        auto [lines_cleared, tspin_type, perfect_clear] = matrix_->Commit(tetromino_.type(), last_move_, pos_, rotation_data_);
+        auto [lines_cleared, tspin_type, perfect_clear] = matrix_->Commit(tetromino_.type(), angle_, last_move_, pos_);
 
         if (perfect_clear) {
           events_.Push(Event::Type::PerfectClear);
@@ -32,15 +32,15 @@ class TetrominoSprite {
       state_ = (got_lines) ? State::KO : State::GameOver;
       return;
     }
-    matrix_->Insert(pos_, rotation_data_);
+    matrix_->Insert(tetromino_.type(), angle_, pos_);
     level_->ResetTime();
     state_ = State::Falling;
   }
 
-  void Render(const std::shared_ptr<SDL_Texture>& texture) const {
+  void Render(uint8_t alpha) const {
     const Position adjusted_pos(pos_.row() - kVisibleRowStart, pos_.col() - kVisibleColStart);
 
-    tetromino_.Render(adjusted_pos.x(), adjusted_pos.y(), texture.get(), angle_);
+    tetromino_.Render(adjusted_pos.x(), adjusted_pos.y(), angle_, alpha);
   }
 
   inline const Tetromino& tetromino() const { return tetromino_; }
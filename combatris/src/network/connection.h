@@ -3,11 +3,23 @@
 #include "utility/timer.h"
 #include "network/protocol.h"
 #include "network/protocol_timing_settings.h"
+#include "network/matrix_state_codec.h"
 
+#include <cmath>
 #include <iostream>
 
 namespace network {
 
+// Smoothed round-trip time, jitter (mean deviation of the round-trip time) and offset of the clock of the other
+// player relative to ours, all in ms. The loss is the smoothed fraction of reliable datagrams lost on the way here.
+struct ConnectionStats {
+  double rtt_ = 0.0;
+  double jitter_ = 0.0;
+  double clock_offset_ = 0.0;
+  double loss_ = 0.0;
+  int samples_ = 0;
+};
+
 class Connection final {
  public:
   Connection(const std::string host_name, const PackageArray& package_array) {
@@ -18,7 +30,6 @@ class Connection final {
       }
     }
     name_ = host_name;
-    timestamp_ = utility::time_in_ms();
   }
 
   void Update(Channel channel, const Header& header) {
@@ -34,11 +45,8 @@ class Connection final {
     } else {
       sequence_nr_unreliable_ = header.sequence_nr() + 1;
     }
-    IsAlive();
   }
 
-  void IsAlive() { timestamp_ = utility::time_in_ms(); }
-
   int64_t VerifySequenceNumber(Channel channel, const Header& header) {
     if (Channel::Unreliable == channel) {
       if (sequence_nr_unreliable_ == -1) {
@@ -52,6 +60,11 @@ class Connection final {
       return index;
     }
     const auto gap = static_cast<int64_t>(header.sequence_nr()) - sequence_nr_reliable_;
+
+    // Every datagram carries one new package, so the gap is the number of datagrams lost since the previous one
+    if (gap >= 0) {
+      stats_.loss_ += (gap / (gap + 1.0) - stats_.loss_) / 8.0;
+    }
 #if !defined(NDEBUG)
     if (gap != 0) {
       std::cout << name_ << ": gap detected, expected - " << sequence_nr_reliable_ << ", got " << header.sequence_nr() << "\n";
@@ -60,15 +73,17 @@ class Connection final {
     return gap;
   }
 
-  bool has_timed_out() const {
-    auto time_since_last_update = utility::time_in_ms() - timestamp_;
+  // Every datagram sent carries a new newest package, so a datagram with a newest package that has been seen is a
+  // duplicate, e.g. received on two interfaces, or carries nothing that a later datagram didn't
+  bool IsDuplicate(Channel channel, const Header& header) const {
+    const auto expected = (Channel::Reliable == channel) ? sequence_nr_reliable_ : sequence_nr_unreliable_;
 
-    if (time_since_last_update >= kConnectionMissing) {
-      std::cout << name_ << " is missing, last update " << time_since_last_update << " ms ago\n";
-      is_missing_ = true;
-    }
+    return expected != -1 && header.sequence_nr() < expected;
+  }
 
-    return time_since_last_update >= kConnectionTimeOut;
+  void SetIsMissing() {
+    std::cout << name_ << " is missing, last update " << kConnectionMissing << " ms ago\n";
+    is_missing_ = true;
   }
 
   bool has_joined() const { return has_joined_; }
@@ -77,14 +92,50 @@ class Connection final {
 
   const std::string& name() const { return name_; }
 
+  bool DecodeMatrixState(const ProgressPayload& payload, MatrixState& state) {
+    return matrix_state_decoder_.Decode(payload, state);
+  }
+
+  // Returns true if the time stamps echoed one of our datagrams, i.e. gave a new round-trip time sample. The estimates
+  // are smoothed like the retransmission timer in RFC 6298, the clock offset is calculated like in NTP.
+  bool UpdateTimeStamps(const TimeStamps& time_stamps, uint64_t our_host_id, uint32_t now) {
+    if (time_stamps.echo_host_id() != our_host_id) {
+      return false;
+    }
+    const auto rtt = static_cast<int32_t>(now - time_stamps.echo_time() - time_stamps.echo_delay());
+
+    if (rtt < 0 || rtt > kConnectionTimeOut) {
+      return false;
+    }
+    const auto peer_received_at = time_stamps.send_time() - time_stamps.echo_delay();
+    const auto clock_offset = (static_cast<int32_t>(peer_received_at - time_stamps.echo_time()) +
+                               static_cast<int32_t>(time_stamps.send_time() - now)) / 2.0;
+
+    if (0 == stats_.samples_) {
+      stats_.rtt_ = rtt;
+      stats_.jitter_ = rtt / 2.0;
+      stats_.clock_offset_ = clock_offset;
+    } else {
+      stats_.jitter_ += (std::abs(stats_.rtt_ - rtt) - stats_.jitter_) / 4.0;
+      stats_.rtt_ += (rtt - stats_.rtt_) / 8.0;
+      stats_.clock_offset_ += (clock_offset - stats_.clock_offset_) / 8.0;
+    }
+    stats_.samples_++;
+
+    return true;
+  }
+
+  const ConnectionStats& stats() const { return stats_; }
+
  private:
   std::string name_;
   int start_with_package_ = 0;
   bool has_joined_ = false;
-  mutable bool is_missing_ = false;
-  int64_t timestamp_;
+  bool is_missing_ = false;
   int64_t sequence_nr_reliable_ = -1;
   int64_t sequence_nr_unreliable_= -1;
+  MatrixStateDecoder matrix_state_decoder_;
+  ConnectionStats stats_;
 };
 
 } // namespace Connection
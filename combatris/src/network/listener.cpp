@@ -1,65 +1,122 @@
 #include "network/listener.h"
 
+#include <algorithm>
+
 namespace network {
 
-void Listener::TerminateTimedOutConnections() {
-  for (auto it = connections_.begin(); it != connections_.end();) {
-    const auto& connection = it->second;
-
-    if (connection.has_timed_out()) {
-      std::cout << connection.name() << " timed out, connection terminated" << "\n";
-      queue_->Push(Response(Request::Leave, it->first));
-      it = connections_.erase(it);
-    } else {
-      ++it;
-    }
+TimeStamps Listener::CreateTimeStamps() {
+  const auto now = static_cast<uint32_t>(utility::time_in_ms());
+  TimeStamps time_stamps(now);
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  auto oldest = std::min_element(echoes_.begin(), echoes_.end(),
+                                 [](const auto& a, const auto& b) { return a.second.received_at_ < b.second.received_at_; });
+
+  if (oldest != echoes_.end()) {
+    time_stamps.SetEcho(oldest->first, oldest->second.send_time_, now - oldest->second.received_at_);
+    echoes_.erase(oldest);
   }
+
+  return time_stamps;
 }
 
-template<typename From, typename A, typename B>
-std::pair<A, B> CastBuffer(char* buffer) {
-  From* package = reinterpret_cast<From *>(buffer);
+bool Listener::GetConnectionStats(uint64_t host_id, ConnectionStats& stats) const {
+  std::lock_guard<std::mutex> lock(mutex_);
 
-  return std::make_pair(std::move(package->header_), std::move(package->package_));
+  if (stats_.count(host_id) == 0) {
+    return false;
+  }
+  stats = stats_.at(host_id);
+
+  return true;
 }
 
-void Listener::HandleReliableChannel(ssize_t size, char* buffer) {
+void Listener::UpdateTimeStamps(uint64_t host_id, Connection& connection, const TimeStamps& time_stamps) {
+  if (host_id == our_host_id_) {
+    return;
+  }
+  const auto now = static_cast<uint32_t>(utility::time_in_ms());
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  echoes_[host_id] = Echo{ time_stamps.send_time(), now };
+  connection.UpdateTimeStamps(time_stamps, our_host_id_, now);
+}
+
+void Listener::PublishStats(uint64_t host_id, const Connection& connection) {
+  if (host_id == our_host_id_) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  stats_[host_id] = connection.stats();
+}
+
+void Listener::EraseConnection(uint64_t host_id) {
+  connections_.erase(host_id);
+  liveness_.Remove(host_id);
+
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  echoes_.erase(host_id);
+  stats_.erase(host_id);
+}
+
+void Listener::TerminateTimedOutConnections() {
+  liveness_.Advance([this](uint64_t host_id) { connections_.at(host_id).SetIsMissing(); },
+                    [this](uint64_t host_id) {
+                      std::cout << connections_.at(host_id).name() << " timed out, connection terminated" << "\n";
+                      queue_->Push(Response(Request::Leave, host_id));
+                      EraseConnection(host_id);
+                    });
+}
+
+namespace {
+
+// Typed view of a datagram in place in the receive buffer, the packages are packed so any address will do
+template<typename T>
+const T* PackageView(const char* buffer) {
+  static_assert(alignof(T) == 1);
+
+  return reinterpret_cast<const T*>(buffer);
+}
+
+} // namespace
+
+void Listener::HandleReliableChannel(ssize_t size, const char* buffer) {
   if (size != static_cast<ssize_t>(sizeof(ReliablePackage))) {
     std::cout << "incomplete package - " << size << std::endl;
     return;
   }
-  auto [package_header, package_array] = CastBuffer<ReliablePackage, PackageHeader, PackageArray>(buffer);
-
+  const auto* reliable_package = PackageView<ReliablePackage>(buffer);
+  const auto& package_header = reliable_package->header_;
+  const auto& package_array = reliable_package->package_;
   const uint64_t host_id = package_header.host_id();
-  const auto& host_name = package_header.host_name();
 
   if (connections_.count(host_id) == 0) {
-    connections_.insert(std::make_pair(host_id, Connection(host_name, package_array)));
+    connections_.insert(std::make_pair(host_id, Connection(package_header.host_name(), package_array)));
   }
   auto& connection = connections_.at(host_id);
-  auto package_index = connection.VerifySequenceNumber(Channel::Reliable, package_array.packages_[0].header_);
 
-  if (package_index < 0) {
-#if !defined(NDEBUG)
-    std::cout << "old package(s) ignored\n";
-#endif
-    connection.IsAlive();
+  if (connection.IsDuplicate(Channel::Reliable, package_array.packages_[0].header_)) {
+    duplicates_received_.fetch_add(1, std::memory_order_relaxed);
     return;
   }
+  liveness_.Refresh(host_id);
+  UpdateTimeStamps(host_id, connection, reliable_package->time_stamps_);
+
+  auto package_index = connection.VerifySequenceNumber(Channel::Reliable, package_array.packages_[0].header_);
+
+  PublishStats(host_id, connection);
   if (package_index > package_array.size() || package_index >= kWindowSize) {
-    std::cout << host_name << " has lost too many packages, connection will be terminated" << std::endl;
-    connections_.erase(host_id);
+    std::cout << package_header.host_name_view() << " has lost too many packages, connection will be terminated" << std::endl;
+    EraseConnection(host_id);
     queue_->Push(Response(Request::Leave, host_id));
     return;
   }
-  std::vector<Package> package_vector;
-
   for (auto i = package_index; i >= 0; --i) {
-    package_vector.push_back(package_array.packages_[i]);
-  }
-  for (const auto& package : package_vector) {
-    bool process_request = true;
+    const auto& package = package_array.packages_[i];
     const auto& header = package.header_;
+    bool process_request = true;
 
     if (!header.Verify()) {
       std::cout << "Unknown package signature - package ignored" << std::endl;
@@ -74,8 +131,10 @@ void Listener::HandleReliableChannel(ssize_t size, char* buffer) {
         if (!connection.has_joined()) {
           std::cout << "Error: not joined" << std::endl;
         }
-        connections_.erase(host_id);
-        break;
+        // The connection is gone, whatever follows in the window belongs to a new session
+        EraseConnection(host_id);
+        queue_->Push(Response(package_header, package));
+        return;
       case Request::HeartBeat:
         process_request = false;
         break;
@@ -89,12 +148,17 @@ void Listener::HandleReliableChannel(ssize_t size, char* buffer) {
   }
 }
 
-void Listener::HandleUnreliableChannel(ssize_t size, char* buffer) {
-  if (size != static_cast<ssize_t>(sizeof(UnreliablePackage))) {
+void Listener::HandleUnreliableChannel(ssize_t size, const char* buffer) {
+  const auto* unreliable_package = PackageView<UnreliablePackage>(buffer);
+
+  if (size < static_cast<ssize_t>(sizeof(UnreliablePackage) - kMatrixStateSize) ||
+      size != static_cast<ssize_t>(unreliable_package->size()) ||
+      unreliable_package->package_.payload_.size() > kMatrixStateSize) {
     std::cout << "UnreliableChannel - package - " << size << std::endl;
     return;
   }
-  auto [package_header, progress_package] = CastBuffer<UnreliablePackage, PackageHeader, ProgressPackage>(buffer);
+  const auto& package_header = unreliable_package->header_;
+  const auto& progress_package = unreliable_package->package_;
 
   if (!package_header.Verify()) {
     std::cout << "UnreliableChannel - Unknown package signature - package ignored" << std::endl;
@@ -108,60 +172,80 @@ void Listener::HandleUnreliableChannel(ssize_t size, char* buffer) {
   }
   auto& connection = connections_.at(host_id);
 
-  if (connection.VerifySequenceNumber(Channel::Unreliable, progress_package.header_ ) < 0) {
+  if (connection.IsDuplicate(Channel::Unreliable, progress_package.header_)) {
+    duplicates_received_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+  liveness_.Refresh(host_id);
+  connection.Update(Channel::Unreliable, progress_package.header_);
+
+  const auto& payload = progress_package.payload_;
+
+  if (MatrixEncoding::Piece == payload.encoding()) {
+    if (payload.size() == sizeof(PieceState)) {
+      queue_->Push(Response(package_header, payload));
+    }
+    return;
+  }
+  MatrixState matrix_state;
+
+  if (!connection.DecodeMatrixState(payload, matrix_state)) {
 #if !defined(NDEBUG)
-    std::cout << "UnreliableChannel - old package(s) ignored\n";
+    std::cout << "UnreliableChannel - missing key frame, update ignored\n";
 #endif
-    connection.IsAlive();
     return;
   }
-  connection.Update(Channel::Unreliable, progress_package.header_);
-  queue_->Push(Response(package_header, progress_package));
+  queue_->Push(Response(package_header, ProgressPayload(payload.lines(), payload.score(), payload.level(), matrix_state)));
 }
 
-void Listener::Run() {
-  UDPServer server(GetPort());
+ssize_t Listener::Poll(int max_wait_ms) {
   char buffer[2500];
 
   static_assert(sizeof(buffer) >= sizeof(ReliablePackage) && sizeof(buffer) >= sizeof(UnreliablePackage));
 
-  auto last_timeout_check  = utility::time_in_ms();
+  auto size = receiver_->Receive(buffer, sizeof(buffer), max_wait_ms);
 
-  for (;;) {
-    if (cancelled_.load(std::memory_order_acquire)) {
-      break;
+  if (size == SOCKET_ERROR) {
+    if (!cancelled_.load(std::memory_order_acquire)) {
+      failed_.store(true, std::memory_order_release);
     }
-    auto size = server.Receive(buffer, sizeof(buffer), kWaitForIncomingPackages);
+    return size;
+  }
+  TerminateTimedOutConnections();
+  if (size == SOCKET_TIMEOUT) {
+    return size;
+  }
+  datagrams_received_.fetch_add(1, std::memory_order_relaxed);
+  if (capture_) {
+    capture_->Write(buffer, static_cast<size_t>(size));
+  }
 
-    if (cancelled_.load(std::memory_order_acquire)) {
+  if (size < static_cast<ssize_t>(sizeof(PackageHeader))) {
+    std::cout << "incomplete package header - " << size << std::endl;
+    return size;
+  }
+  switch (PackageView<PackageHeader>(buffer)->channel()) {
+    case Channel::Unreliable:
+      HandleUnreliableChannel(size, buffer);
       break;
-    }
-    if (size == SOCKET_ERROR) {
-      exit(0);
-    }
-    if ((utility::time_in_ms() - last_timeout_check) >= kConnectionCheckAliveInterval) {
-      TerminateTimedOutConnections();
-      last_timeout_check = utility::time_in_ms();
-    }
-    if (size == SOCKET_TIMEOUT) {
-      continue;
-    }
-    PackageHeader *header = reinterpret_cast<PackageHeader*>(buffer);
+    case Channel::Reliable:
+      HandleReliableChannel(size, buffer);
+      break;
+    default:
+      std::cout << "None" << std::endl;
+      break;
+  }
+
+  return size;
+}
 
-    if (size < static_cast<ssize_t>(sizeof(PackageHeader))) {
-      std::cout << "incomplete package header - " << size << std::endl;
-      return;
+void Listener::Run() {
+  for (;;) {
+    if (cancelled_.load(std::memory_order_acquire)) {
+      break;
     }
-    switch (header->channel()) {
-      case Channel::Unreliable:
-        HandleUnreliableChannel(size, buffer);
-        break;
-      case Channel::Reliable:
-        HandleReliableChannel(size, buffer);
-        break;
-      default:
-        std::cout << "None" << std::endl;
-        break;
+    if (Poll(kWaitForIncomingPackages) == SOCKET_ERROR) {
+      break;
     }
   }
 }
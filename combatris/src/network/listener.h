@@ -3,45 +3,92 @@
 #include "utility/threadsafe_queue.h"
 #include "network/udp_client_server.h"
 #include "network/connection.h"
+#include "network/liveness_monitor.h"
+#include "network/session_capture.h"
 
 #include <memory>
+#include <mutex>
+#include <new>
 #include <thread>
+#include <type_traits>
 #include <unordered_map>
 
 namespace network {
 
 class Listener final {
  public:
-  struct Response {
-    Response() = default;
-
-    Response(Request request, uint64_t host_id) : request_(request), host_id_(host_id) {}
+  // Compact tagged union, the payload kind is given by the request. The host name is held in place so a response
+  // can be built and queued without allocating.
+  class Response final {
+   public:
+    Response() : request_(Request::Empty), host_id_(0) { host_name_[0] = '\0'; }
+
+    Response(Request request, uint64_t host_id) : request_(request), host_id_(host_id) { host_name_[0] = '\0'; }
+
+    Response(const PackageHeader& package_header, const Package& package)
+        : request_(package.header_.request()), host_id_(package_header.host_id()) {
+      SetHostName(package_header.host_name_view());
+      new (&data_.payload_) Payload(package.payload_);
+    }
 
-    Response(const PackageHeader& package_header, const Package& package) {
-      request_ = package.header_.request();
-      host_name_ = package_header.host_name();
-      host_id_ = package_header.host_id();
-      payload_ = package.payload_;
+    Response(const PackageHeader& package_header, const ProgressPayload& payload)
+        : request_(Request::ProgressUpdate), host_id_(package_header.host_id()) {
+      SetHostName(package_header.host_name_view());
+      new (&data_.progress_payload_) ProgressPayload(payload);
     }
 
-    Response(const PackageHeader& package_header, const ProgressPackage& package) {
-      request_ = Request::ProgressUpdate;
-      host_name_ = package_header.host_name();
-      host_id_ = package_header.host_id();
-      progress_payload_ = package.payload_;
+    inline Request request() const { return request_; }
+
+    inline uint64_t host_id() const { return host_id_; }
+
+    inline std::string host_name() const { return host_name_; }
+
+    inline const Payload& payload() const { return data_.payload_; }
+
+    // Only valid for progress updates
+    inline const ProgressPayload& progress_payload() const { return data_.progress_payload_; }
+
+   private:
+    void SetHostName(std::string_view name) {
+      const auto size = std::min(name.size(), kHostNameMax);
+
+      std::copy(name.begin(), name.begin() + size, host_name_);
+      host_name_[size] = '\0';
     }
 
+    // The payload types have constructors, so the member in use is created with placement new rather than assigned.
+    // Both are trivially copyable and destructible, which lets the union be copied and dropped as is.
+    union Data {
+      Data() : payload_() {}
+
+      Payload payload_;
+      ProgressPayload progress_payload_;
+    };
+
     Request request_;
-    std::string host_name_;
     uint64_t host_id_;
-    Payload payload_;
-    ProgressPayload progress_payload_;
+    char host_name_[kHostNameMax + 1];
+    Data data_;
   };
 
-  Listener() : cancelled_(false) {
+  static_assert(std::is_trivially_copyable_v<Payload> && std::is_trivially_destructible_v<Payload>);
+  static_assert(std::is_trivially_copyable_v<ProgressPayload> && std::is_trivially_destructible_v<ProgressPayload>);
+
+  Listener() : Listener(std::make_unique<UDPServer>(GetPort(), GetMulticastGroup()), GetHostName()) {}
+
+  // Without a thread of its own the listener is driven by calling Poll
+  Listener(std::unique_ptr<Receiver> receiver, const std::string& our_host_name, bool start_thread = true)
+      : cancelled_(false), our_host_id_(std::hash<std::string>{}(our_host_name)), receiver_(std::move(receiver)) {
     cancelled_.store(false, std::memory_order_release);
     queue_ = std::make_unique<ThreadSafeQueue<Response>>();
-    thread_ = std::make_unique<std::thread>(std::bind(&Listener::Run, this));
+    const auto capture_file = GetCaptureFile();
+
+    if (!capture_file.empty()) {
+      capture_ = std::make_unique<SessionCapture>(GetSessionCaptureFile(capture_file));
+    }
+    if (start_thread) {
+      thread_ = std::make_unique<std::thread>(std::bind(&Listener::Run, this));
+    }
   }
 
   Listener(const Listener&) = delete;
@@ -52,6 +99,13 @@ class Listener final {
 
   inline Response NextPackage() { return queue_->Pop(); }
 
+  inline size_t queue_size() const { return queue_->size(); }
+
+  inline uint64_t datagrams_received() const { return datagrams_received_.load(std::memory_order_relaxed); }
+
+  // Datagrams dropped since they, or a later datagram, had already been received
+  inline uint64_t duplicates_received() const { return duplicates_received_.load(std::memory_order_relaxed); }
+
   void Wait() {
     if (!thread_) {
       return;
@@ -70,17 +124,51 @@ class Listener final {
     Wait();
   }
 
+  // Receives and handles one datagram, returns the size of the datagram, SOCKET_TIMEOUT or SOCKET_ERROR
+  ssize_t Poll(int max_wait_ms);
+
+  inline int file_descriptor() const { return receiver_->file_descriptor(); }
+
+  // Set when receiving failed, nothing more will be received
+  inline bool has_failed() const { return failed_.load(std::memory_order_acquire); }
+
+  void TerminateTimedOutConnections();
+
+  // Time stamps for the next reliable datagram we send, echoing the player we have waited longest to echo
+  TimeStamps CreateTimeStamps();
+
+  bool GetConnectionStats(uint64_t host_id, ConnectionStats& stats) const;
+
  private:
+  struct Echo {
+    uint32_t send_time_;
+    uint32_t received_at_;
+  };
+
   void Run();
 
-  void TerminateTimedOutConnections();
+  void UpdateTimeStamps(uint64_t host_id, Connection& connection, const TimeStamps& time_stamps);
+
+  void PublishStats(uint64_t host_id, const Connection& connection);
+
+  void EraseConnection(uint64_t host_id);
 
-  void HandleReliableChannel(ssize_t size, char* buffer);
+  void HandleReliableChannel(ssize_t size, const char* buffer);
 
-  void HandleUnreliableChannel(ssize_t size, char* buffer);
+  void HandleUnreliableChannel(ssize_t size, const char* buffer);
 
   std::atomic<bool> cancelled_;
+  std::atomic<bool> failed_{false};
+  std::atomic<uint64_t> datagrams_received_{0};
+  std::atomic<uint64_t> duplicates_received_{0};
+  const uint64_t our_host_id_;
+  std::unique_ptr<Receiver> receiver_;
+  std::unique_ptr<SessionCapture> capture_;
   std::unordered_map<uint64_t, Connection> connections_;
+  LivenessMonitor liveness_;
+  mutable std::mutex mutex_;
+  std::unordered_map<uint64_t, Echo> echoes_;
+  std::unordered_map<uint64_t, ConnectionStats> stats_;
   std::unique_ptr<ThreadSafeQueue<Response>> queue_;
   std::unique_ptr<std::thread> thread_;
 };
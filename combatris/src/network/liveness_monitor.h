@@ -0,0 +1,48 @@
+#pragma once
+
+#include "utility/timer.h"
+#include "utility/timer_wheel.h"
+#include "network/protocol_timing_settings.h"
+
+#include <unordered_set>
+
+namespace network {
+
+// Keeps a liveness deadline per connection, refreshed by every datagram from the other end. A connection is missing
+// after kConnectionMissing ms of silence and timed out after kConnectionTimeOut ms.
+class LivenessMonitor final {
+ public:
+  LivenessMonitor() : timers_(kLivenessResolution, kLivenessSlots, utility::time_in_ms()) {}
+
+  void Refresh(uint64_t host_id) {
+    missing_.erase(host_id);
+    timers_.Schedule(host_id, utility::time_in_ms() + kConnectionMissing);
+  }
+
+  void Remove(uint64_t host_id) {
+    missing_.erase(host_id);
+    timers_.Cancel(host_id);
+  }
+
+  template<typename OnMissing, typename OnTimedOut>
+  void Advance(OnMissing on_missing, OnTimedOut on_timed_out) {
+    const auto now = utility::time_in_ms();
+
+    timers_.Advance(now, [&](uint64_t host_id) {
+      if (missing_.count(host_id) > 0) {
+        missing_.erase(host_id);
+        on_timed_out(host_id);
+        return;
+      }
+      missing_.insert(host_id);
+      timers_.Schedule(host_id, now + kConnectionTimeOut - kConnectionMissing);
+      on_missing(host_id);
+    });
+  }
+
+ private:
+  utility::TimerWheel<uint64_t> timers_;
+  std::unordered_set<uint64_t> missing_;
+};
+
+} // namespace network
@@ -0,0 +1,111 @@
+#include "network/loopback_transport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace network {
+
+namespace {
+
+// A reordered datagram is held back long enough to be overtaken by the next datagram
+const int kReorderDelay = 50;
+
+} // namespace
+
+int64_t LoopbackNetwork::now() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  return now_;
+}
+
+void LoopbackNetwork::Advance(int64_t ms) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  now_ += ms;
+}
+
+size_t LoopbackNetwork::datagrams_in_flight() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  size_t datagrams = 0;
+
+  for (const auto& [receiver_id, queue] : queues_) {
+    datagrams += queue.size();
+  }
+
+  return datagrams;
+}
+
+int LoopbackNetwork::Attach() {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  queues_.emplace(next_receiver_id_, Queue());
+
+  return next_receiver_id_++;
+}
+
+void LoopbackNetwork::Detach(int receiver_id) {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  queues_.erase(receiver_id);
+}
+
+bool LoopbackNetwork::Happens(double probability) {
+  return std::uniform_real_distribution<double>(0.0, 1.0)(generator_) < probability;
+}
+
+void LoopbackNetwork::Enqueue(Queue& queue, const char* buff, size_t size, int from) {
+  auto delay = faults_.latency_;
+
+  if (faults_.jitter_ > 0) {
+    delay += std::uniform_int_distribution<int>(0, faults_.jitter_)(generator_);
+  }
+  if (Happens(faults_.reordering_)) {
+    delay += faults_.jitter_ + kReorderDelay;
+  }
+  queue.insert(Datagram{ now_ + delay, order_++, from, std::vector<char>(buff, buff + size) });
+}
+
+void LoopbackNetwork::Send(const void* buff, size_t size, int from, int to) {
+  const auto data = static_cast<const char*>(buff);
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& [receiver_id, queue] : queues_) {
+      if ((kLoopbackAnyReceiver != to && receiver_id != to) || Happens(faults_.loss_)) {
+        continue;
+      }
+      Enqueue(queue, data, size, from);
+      if (Happens(faults_.duplication_)) {
+        Enqueue(queue, data, size, from);
+      }
+    }
+  }
+  sent_.notify_all();
+}
+
+ssize_t LoopbackNetwork::Receive(int receiver_id, void* buff, size_t max_size, int& from, int max_wait_ms) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  auto& queue = queues_.at(receiver_id);
+
+  if (!sent_.wait_for(lock, std::chrono::milliseconds(max_wait_ms), [&queue] { return !queue.empty(); })) {
+    return SOCKET_TIMEOUT;
+  }
+  auto datagram = queue.begin();
+
+  if (datagram->deliver_at_ > now_ + max_wait_ms) {
+    now_ += max_wait_ms;
+    return SOCKET_TIMEOUT;
+  }
+  now_ = std::max(now_, datagram->deliver_at_);
+
+  const auto size = std::min(max_size, datagram->data_.size());
+
+  std::memcpy(buff, datagram->data_.data(), size);
+  from = datagram->from_;
+  queue.erase(datagram);
+
+  return static_cast<ssize_t>(size);
+}
+
+} // namespace network
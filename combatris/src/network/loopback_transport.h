@@ -0,0 +1,138 @@
+#pragma once
+
+#include "network/transport.h"
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <tuple>
+#include <vector>
+
+namespace network {
+
+// Receiver id that addresses every receiver, or no receiver as the sender of a datagram
+const int kLoopbackAnyReceiver = -1;
+
+// Probabilities are in the range [0, 1], latency and jitter in ms
+struct FaultSettings {
+  double loss_ = 0.0;
+  double duplication_ = 0.0;
+  double reordering_ = 0.0;
+  int latency_ = 0;
+  int jitter_ = 0;
+};
+
+// In-process network with a virtual clock, every datagram sent is delivered to every receiver (like a broadcast) unless
+// it's lost on the way or sent to one receiver. The receiver ids are the addresses of the network, a datagram carries
+// the id of the receiver that replies go to. The faults are drawn from a seeded generator, so a single threaded run is
+// deterministic.
+class LoopbackNetwork final {
+ public:
+  LoopbackNetwork(uint32_t seed, const FaultSettings& faults) : generator_(seed), faults_(faults) {}
+
+  LoopbackNetwork(const LoopbackNetwork&) = delete;
+
+  int64_t now() const;
+
+  void Advance(int64_t ms);
+
+  size_t datagrams_in_flight() const;
+
+ private:
+  friend class LoopbackTransmitter;
+  friend class LoopbackReceiver;
+
+  struct Datagram {
+    int64_t deliver_at_;
+    uint64_t order_;
+    int from_;
+    std::vector<char> data_;
+
+    bool operator<(const Datagram& datagram) const {
+      return std::tie(deliver_at_, order_) < std::tie(datagram.deliver_at_, datagram.order_);
+    }
+  };
+
+  using Queue = std::set<Datagram>;
+
+  int Attach();
+
+  void Detach(int receiver_id);
+
+  void Send(const void* buff, size_t size, int from, int to);
+
+  ssize_t Receive(int receiver_id, void* buff, size_t max_size, int& from, int max_wait_ms);
+
+  void Enqueue(Queue& queue, const char* buff, size_t size, int from);
+
+  bool Happens(double probability);
+
+  mutable std::mutex mutex_;
+  std::condition_variable sent_;
+  std::mt19937 generator_;
+  FaultSettings faults_;
+  int64_t now_ = 0;
+  uint64_t order_ = 0;
+  int next_receiver_id_ = 0;
+  std::map<int, Queue> queues_;
+};
+
+class LoopbackTransmitter final : public Transmitter {
+ public:
+  // Like a client sending to a relay rather than broadcasting when to is a receiver, from is where the replies go
+  LoopbackTransmitter(const std::shared_ptr<LoopbackNetwork>& network, const std::string& host_name,
+                      int from = kLoopbackAnyReceiver, int to = kLoopbackAnyReceiver)
+      : network_(network), host_name_(host_name), from_(from), to_(to) {}
+
+  virtual ssize_t Send(const void* buff, size_t size) override {
+    network_->Send(buff, size, from_, to_);
+
+    return static_cast<ssize_t>(size);
+  }
+
+  virtual const std::string& host_name() const override { return host_name_; }
+
+ private:
+  std::shared_ptr<LoopbackNetwork> network_;
+  std::string host_name_;
+  int from_;
+  int to_;
+};
+
+// Datagrams in flight are received as soon as the virtual clock has passed their delivery time, waiting moves the
+// virtual clock forward. If nothing is in flight, the receiver waits up to max_wait_ms real time for a datagram.
+class LoopbackReceiver final : public Receiver {
+ public:
+  explicit LoopbackReceiver(const std::shared_ptr<LoopbackNetwork>& network)
+      : network_(network), receiver_id_(network->Attach()) {}
+
+  virtual ~LoopbackReceiver() noexcept { network_->Detach(receiver_id_); }
+
+  virtual ssize_t Receive(void* buff, size_t max_size, int max_wait_ms) override {
+    int from;
+
+    return network_->Receive(receiver_id_, buff, max_size, from, max_wait_ms);
+  }
+
+  ssize_t Receive(void* buff, size_t max_size, int& from, int max_wait_ms) {
+    return network_->Receive(receiver_id_, buff, max_size, from, max_wait_ms);
+  }
+
+  // Sends from this receiver to one receiver, or to every receiver
+  ssize_t Send(const void* buff, size_t size, int to) {
+    network_->Send(buff, size, receiver_id_, to);
+
+    return static_cast<ssize_t>(size);
+  }
+
+  inline int id() const { return receiver_id_; }
+
+ private:
+  std::shared_ptr<LoopbackNetwork> network_;
+  int receiver_id_;
+};
+
+} // namespace network
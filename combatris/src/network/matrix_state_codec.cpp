@@ -0,0 +1,109 @@
+#include "network/matrix_state_codec.h"
+
+namespace network {
+
+namespace {
+
+const int kMaxRunLength = UCHAR_MAX;
+
+} // namespace
+
+int XorRunLengthEncode(const MatrixState& state, const MatrixState& reference, uint8_t* out, int max_size) {
+  int size = 0;
+  int i = 0;
+
+  while (i < kMatrixStateSize) {
+    int unchanged = 0;
+
+    while (i < kMatrixStateSize && unchanged < kMaxRunLength && state[i] == reference[i]) {
+      unchanged++;
+      i++;
+    }
+    if (i == kMatrixStateSize) {
+      break;
+    }
+    int changed = 0;
+
+    while (i + changed < kMatrixStateSize && changed < kMaxRunLength && state[i + changed] != reference[i + changed]) {
+      changed++;
+    }
+    if (size + 2 + changed > max_size) {
+      return -1;
+    }
+    out[size++] = static_cast<uint8_t>(unchanged);
+    out[size++] = static_cast<uint8_t>(changed);
+    for (int n = 0; n < changed; ++n, ++i) {
+      out[size++] = state[i] ^ reference[i];
+    }
+  }
+
+  return size;
+}
+
+bool XorRunLengthDecode(const uint8_t* in, int size, const MatrixState& reference, MatrixState& state) {
+  state = reference;
+
+  int i = 0;
+  int pos = 0;
+
+  while (pos < size) {
+    if (pos + 2 > size) {
+      return false;
+    }
+    const int unchanged = in[pos++];
+    const int changed = in[pos++];
+
+    i += unchanged;
+    if (i + changed > kMatrixStateSize || pos + changed > size) {
+      return false;
+    }
+    for (int n = 0; n < changed; ++n, ++i) {
+      state[i] ^= in[pos++];
+    }
+  }
+
+  return true;
+}
+
+void MatrixStateEncoder::Encode(const MatrixState& state, ProgressPayload& payload) {
+  if (updates_since_key_frame_ < kKeyFrameInterval) {
+    auto size = XorRunLengthEncode(state, key_frame_state_, payload.data(), kMatrixStateSize - 1);
+
+    if (size >= 0) {
+      payload.SetMatrixData(MatrixEncoding::Delta, key_frame_, static_cast<uint8_t>(size));
+      updates_since_key_frame_++;
+      return;
+    }
+  }
+  key_frame_++;
+  key_frame_state_ = state;
+  updates_since_key_frame_ = 1;
+  payload.SetMatrixState(key_frame_, state);
+}
+
+// The size is read off the wire, a size larger than the payload would decode whatever follows it
+bool MatrixStateDecoder::Decode(const ProgressPayload& payload, MatrixState& state) {
+  if (payload.size() > kMatrixStateSize) {
+    return false;
+  }
+  switch (payload.encoding()) {
+    case MatrixEncoding::KeyFrame:
+      if (payload.size() != kMatrixStateSize) {
+        return false;
+      }
+      key_frame_state_ = payload.matrix_state();
+      key_frame_ = payload.key_frame();
+      has_key_frame_ = true;
+      state = key_frame_state_;
+      return true;
+    case MatrixEncoding::Delta:
+      if (!has_key_frame_ || payload.key_frame() != key_frame_) {
+        return false;
+      }
+      return XorRunLengthDecode(payload.data(), payload.size(), key_frame_state_, state);
+    default:
+      return false;
+  }
+}
+
+} // namespace network
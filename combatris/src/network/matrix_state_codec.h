@@ -0,0 +1,41 @@
+#pragma once
+
+#include "network/protocol.h"
+
+namespace network {
+
+// A key frame is sent every kKeyFrameInterval update, all other updates are encoded as a delta against the
+// latest key frame. A lost delta is therefore never a problem, and a lost key frame is recovered by the next one.
+const int kKeyFrameInterval = 8;
+
+// The delta is the XOR between the state and the reference, run length encoded as a sequence of
+// [number of unchanged bytes][number of changed bytes][changed bytes...], trailing unchanged bytes are omitted.
+// Returns the number of bytes written to out or -1 if the result doesn't fit in max_size.
+int XorRunLengthEncode(const MatrixState& state, const MatrixState& reference, uint8_t* out, int max_size);
+
+bool XorRunLengthDecode(const uint8_t* in, int size, const MatrixState& reference, MatrixState& state);
+
+class MatrixStateEncoder final {
+ public:
+  void Encode(const MatrixState& state, ProgressPayload& payload);
+
+  void ForceKeyFrame() { updates_since_key_frame_ = kKeyFrameInterval; }
+
+ private:
+  MatrixState key_frame_state_{};
+  uint16_t key_frame_ = 0;
+  int updates_since_key_frame_ = kKeyFrameInterval;
+};
+
+class MatrixStateDecoder final {
+ public:
+  // Returns false if there is no matrix in the payload or the key frame the delta is based on is missing
+  bool Decode(const ProgressPayload& payload, MatrixState& state);
+
+ private:
+  bool has_key_frame_ = false;
+  uint16_t key_frame_ = 0;
+  MatrixState key_frame_state_{};
+};
+
+} // namespace network
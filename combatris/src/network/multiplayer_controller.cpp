@@ -1,81 +1,159 @@
 #include "network/multiplayer_controller.h"
+#include "network/network_interfaces.h"
 
+#include <algorithm>
 #include <iostream>
-#include <deque>
 
 namespace network {
 
 namespace {
 
-void HeartbeatController(std::atomic<bool>& quit, std::shared_ptr<ThreadSafeQueue<MultiPlayerController::OutgoingPackage>> queue) {
-  while (true) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(kHeartBeatInterval));
+const std::string kEnvInputStream = "COMBATRIS_INPUT_STREAM";
 
-    if (quit.load(std::memory_order_acquire)) {
+const int64_t kTimerResolution = 10;
+const size_t kTimerSlots = 32;
+
+} // namespace
+
+bool UseInputStream() {
+  auto env = getenv(kEnvInputStream.c_str());
+
+  return nullptr != env && std::string(env) != "0";
+}
+
+MultiPlayerController::MultiPlayerController(ListenerInterface* listener_if) : MultiPlayerController(listener_if, nullptr, nullptr) {}
+
+MultiPlayerController::MultiPlayerController(ListenerInterface* listener_if, std::unique_ptr<Transmitter> transmitter,
+                                             std::unique_ptr<Receiver> receiver)
+    : listener_if_(listener_if), transmitter_(std::move(transmitter)),
+      timers_(kTimerResolution, kTimerSlots, utility::time_in_ms()) {
+  if (!Startup()) {
+    error_ = "The network could not be initialized";
+    return;
+  }
+  if (!transmitter_ && BroadcastOnAllInterfaces()) {
+    std::vector<std::string> broadcast_addresses;
+
+    for (const auto& network_interface : GetNetworkInterfaces()) {
+      broadcast_addresses.push_back(network_interface.broadcast_address_);
+      std::cout << "Broadcast IP: " << network_interface.broadcast_address_ << " (" << network_interface.name_ << "), Port: "
+                << GetPort() << std::endl;
+    }
+    auto client = std::make_unique<MultiInterfaceClient>(broadcast_addresses, GetPort());
+
+    if (!client->is_open()) {
+      error_ = client->error();
       return;
     }
-    queue->Push(CreatePackage(Request::HeartBeat));
+    transmitter_ = std::move(client);
   }
-}
+  if (!transmitter_) {
+    const auto destination_address = GetDestinationAddress();
+    auto client = std::make_unique<UDPClient>(destination_address, GetPort());
 
-} // namespace
+    if (!client->is_open()) {
+      error_ = client->error();
+      return;
+    }
+    transmitter_ = std::move(client);
+    std::cout << (GetMulticastGroup().empty() ? "Broadcast IP: " : "Multicast group: ") << destination_address
+              << ", Port: " << GetPort() << std::endl;
+  }
+  if (!receiver) {
+    auto server = std::make_unique<UDPServer>(GetPort(), GetMulticastGroup());
 
-MultiPlayerController::MultiPlayerController(ListenerInterface* listener_if) : listener_if_(listener_if) {
-  Startup();
-  our_host_name_ = GetHostName();
+    if (!server->is_open()) {
+      error_ = server->error();
+      return;
+    }
+    receiver = std::move(server);
+  }
+  our_host_name_ = transmitter_->host_name();
   our_host_id_ = std::hash<std::string>{}(our_host_name_);
-  cancelled_.store(false, std::memory_order_release);
   send_queue_ = std::make_shared<ThreadSafeQueue<OutgoingPackage>>();
-  listener_ = std::make_unique<Listener>();
+#if defined(__linux__)
+  if (receiver->file_descriptor() != -1) {
+    auto reactor = std::make_unique<Reactor>();
+
+    if (reactor->is_open()) {
+      listener_ = std::make_unique<Listener>(std::move(receiver), our_host_name_, false);
+      reactor_ = std::move(reactor);
+      send_thread_ = std::make_unique<std::thread>(std::bind(&MultiPlayerController::RunReactor, this));
+      return;
+    }
+  }
+#endif
+  listener_ = std::make_unique<Listener>(std::move(receiver), our_host_name_);
   send_thread_ = std::make_unique<std::thread>(std::bind(&MultiPlayerController::Run, this));
 }
 
 MultiPlayerController::~MultiPlayerController() noexcept {
-  Leave();
-  do {
-    std::this_thread::sleep_for(std::chrono::milliseconds(200));
-  } while (send_queue_->size() > 0);
-  Cancel();
+  if (listener_) {
+    Leave();
+    Stop();
+  }
   Cleanup();
 }
 
-void MultiPlayerController::Join(GameState state) {
-  if (!heartbeat_thread_) {
-    heartbeat_thread_ = std::make_unique<std::thread>(HeartbeatController, std::ref(cancelled_), send_queue_);
+bool MultiPlayerController::has_failed() const {
+#if defined(__linux__)
+  if (reactor_ && reactor_->has_failed()) {
+    return true;
+  }
+#endif
+  return !error_.empty() || (listener_ && listener_->has_failed());
+}
+
+std::string MultiPlayerController::error() const {
+#if defined(__linux__)
+  if (error_.empty() && reactor_ && reactor_->has_failed()) {
+    return reactor_->error();
   }
-  send_queue_->Push(CreatePackage(Request::Join, state));
+#endif
+  return (error_.empty() && has_failed()) ? "Receiving failed" : error_;
+}
+
+void MultiPlayerController::Join(GameState state) {
+  Enqueue(CreatePackage(Request::Join, state));
 }
 
 void MultiPlayerController::Leave()  {
-  heartbeat_thread_.release();
-  send_queue_->Push(CreatePackage(Request::Leave, GameState::Idle));
+  Enqueue(CreatePackage(Request::Leave, GameState::Idle));
 }
 
-void MultiPlayerController::NewGame() { send_queue_->Push(CreatePackage(Request::NewGame, GameState::Waiting)); }
+void MultiPlayerController::NewGame() { Enqueue(CreatePackage(Request::NewGame, GameState::Waiting)); }
 
-void MultiPlayerController::StartGame() { send_queue_->Push(CreatePackage(Request::StartGame, GameState::Playing)); }
+void MultiPlayerController::StartGame() { Enqueue(CreatePackage(Request::StartGame, GameState::Playing)); }
 
-void MultiPlayerController::SendUpdate(int lines) { send_queue_->Push(CreatePackage(Request::SendLines, lines)); }
+void MultiPlayerController::SendUpdate(int lines) { Enqueue(CreatePackage(Request::SendLines, lines)); }
 
-void MultiPlayerController::SendUpdate(uint64_t host_id) { send_queue_->Push(CreatePackage(Request::KnockedOutBy, host_id)); }
+void MultiPlayerController::SendUpdate(uint64_t host_id) { Enqueue(CreatePackage(Request::KnockedOutBy, host_id)); }
 
-void MultiPlayerController::SendUpdate(GameState state) { send_queue_->Push(CreatePackage(Request::NewState, state)); }
+void MultiPlayerController::SendUpdate(GameState state) { Enqueue(CreatePackage(Request::NewState, state)); }
 
 void MultiPlayerController::SendUpdate(int lines, int score, int level, const MatrixState& state) {
-  send_queue_->Push(CreatePackage(static_cast<uint16_t>(lines), score, static_cast<uint8_t>(level), state));
+  EnqueueProgress(CreatePackage(static_cast<uint16_t>(lines), score, static_cast<uint8_t>(level), state));
 }
 
+void MultiPlayerController::SendUpdate(int lines, int score, int level, const PieceState& piece) {
+  EnqueueProgress(CreatePackage(static_cast<uint16_t>(lines), score, static_cast<uint8_t>(level), piece));
+}
+
+void MultiPlayerController::SendUpdate(const InputEvent& input) { Enqueue(CreatePackage(Request::Input, input.value())); }
+
+void MultiPlayerController::SendSeed(uint64_t seed) { Enqueue(CreatePackage(Request::Seed, seed)); }
+
 void MultiPlayerController::Dispatch() {
-  if (nullptr == listener_if_) {
+  if (nullptr == listener_if_ || !listener_) {
     return;
   }
   while (listener_->packages_available()) {
     auto response = listener_->NextPackage();
-    const auto& host_name = response.host_name_;
-    const auto host_id = response.host_id_;
-    const auto& payload = response.payload_;
+    const auto host_name = response.host_name();
+    const auto host_id = response.host_id();
+    const auto& payload = response.payload();
 
-    switch (response.request_) {
+    switch (response.request()) {
       case Request::Join:
         if (listener_if_->GotJoin(host_name, host_id)) {
           listener_if_->GotNewState(host_id, payload.state());
@@ -103,9 +181,21 @@ void MultiPlayerController::Dispatch() {
       case Request::KnockedOutBy:
         listener_if_->GotPlayerKnockedOut(payload.value());
         break;
-      case Request::ProgressUpdate:
-        listener_if_->GotProgressUpdate(host_id, response.progress_payload_.lines(), response.progress_payload_.score(),
-                                        response.progress_payload_.level(), response.progress_payload_.matrix_state());
+      case Request::ProgressUpdate: {
+          const auto& progress = response.progress_payload();
+
+          if (MatrixEncoding::Piece == progress.encoding()) {
+            listener_if_->GotProgressUpdate(host_id, progress.lines(), progress.score(), progress.level(), progress.piece());
+          } else {
+            listener_if_->GotProgressUpdate(host_id, progress.lines(), progress.score(), progress.level(), progress.matrix_state());
+          }
+        }
+        break;
+      case Request::Seed:
+        listener_if_->GotSeed(host_id, payload.value());
+        break;
+      case Request::Input:
+        listener_if_->GotInput(host_id, InputEvent(payload.value()));
         break;
       default:
         break;
@@ -113,58 +203,169 @@ void MultiPlayerController::Dispatch() {
   }
 }
 
-void MultiPlayerController::Run() {
-  const auto broadcast_address = GetBroadcastAddress();
-  uint32_t sequence_nr_reliable = 0;
-  uint32_t sequence_nr_unreliable = 0;
-  std::deque<Package> sliding_window;
-  UDPClient client(broadcast_address, GetPort());
-  auto time_since_last_package = utility::time_in_ms();
+// Nothing is sent by a controller that failed to start
+void MultiPlayerController::Enqueue(OutgoingPackage package) {
+  if (!send_queue_) {
+    return;
+  }
+  send_queue_->Push(std::move(package));
+#if defined(__linux__)
+  if (reactor_) {
+    reactor_->Wake();
+  }
+#endif
+}
+
+// Only the latest progress update of each kind is sent, an update that hasn't been sent when the next one arrives is
+// replaced by it
+void MultiPlayerController::EnqueueProgress(const ProgressPackage& package) {
+  bool is_pending;
+  {
+    std::lock_guard<std::mutex> lock(progress_mutex_);
+
+    is_pending = !latest_progress_.empty();
+    latest_progress_[package.payload_.encoding()] = package;
+  }
+  if (!is_pending) {
+    Enqueue(OutgoingPackage(Channel::Unreliable));
+  }
+}
 
-  std::cout << "Broadcast IP: " << broadcast_address << ", Port: " << GetPort() << std::endl;
+void MultiPlayerController::Send(Package& package) {
+  auto reliable_package = sliding_window_.Push(transmitter_->host_name(), package);
+
+  reliable_package.time_stamps_ = listener_->CreateTimeStamps();
+  transmitter_->Send(&reliable_package, sizeof(reliable_package));
+
+  // Heartbeats are only sent when nothing else has been sent within the heartbeat interval
+  joined_ = (Request::Join == package.header_.request()) || (joined_ && Request::Leave != package.header_.request());
+  if (joined_) {
+    timers_.Schedule(Timer::HeartBeat, utility::time_in_ms() + kHeartBeatInterval);
+  } else {
+    timers_.Cancel(Timer::HeartBeat);
+  }
+}
+
+void MultiPlayerController::Send(ProgressPackage& package) {
+  package.header_.SetSeqenceNr(sequence_nr_unreliable_);
+  sequence_nr_unreliable_++;
+  if (MatrixEncoding::KeyFrame == package.payload_.encoding()) {
+    matrix_state_encoder_.Encode(package.payload_.matrix_state(), package.payload_);
+  }
+
+  UnreliablePackage unreliable_package(transmitter_->host_name(), package);
+
+  transmitter_->Send(&unreliable_package, unreliable_package.size());
+}
+
+void MultiPlayerController::SendProgressUpdates() {
+  std::map<MatrixEncoding, ProgressPackage> progress;
+  {
+    std::lock_guard<std::mutex> lock(progress_mutex_);
+
+    progress.swap(latest_progress_);
+  }
+  for (auto& [encoding, package] : progress) {
+    Send(package);
+  }
+}
+
+void MultiPlayerController::HandleTimers() {
+  bool send_heartbeat = false;
+
+  timers_.Advance(utility::time_in_ms(), [&send_heartbeat](Timer) { send_heartbeat = true; });
+  if (send_heartbeat) {
+    auto heartbeat = CreatePackage(Request::HeartBeat);
+
+    Send(heartbeat);
+  }
+}
+
+// Reliable packages have priority, the progress updates are sent when the queue is empty
+void MultiPlayerController::Run() {
+  bool progress_pending = false;
 
   for (;;) {
-    if (cancelled_.load(std::memory_order_acquire)) {
-      break;
-    }
     OutgoingPackage outgoing_package;
+    const auto wait = progress_pending ? 0 : std::clamp<int64_t>(timers_.next_deadline() - utility::time_in_ms(), 0,
+                                                                 kWaitForIncomingPackages);
 
-    if (!send_queue_->Pop(outgoing_package)) {
-      break;
+    if (!send_queue_->Pop(outgoing_package, std::chrono::milliseconds(wait))) {
+      if (send_queue_->is_cancelled()) {
+        break;
+      }
+      if (progress_pending) {
+        SendProgressUpdates();
+        progress_pending = false;
+      }
+      HandleTimers();
+      continue;
     }
-    if (cancelled_.load(std::memory_order_acquire)) {
+    if (Channel::None == outgoing_package.channel()) {
+      if (progress_pending) {
+        SendProgressUpdates();
+      }
       break;
     }
-    if (Channel::Reliable == outgoing_package.channel()) {
-      auto& package = outgoing_package.package_;
-
-      if (package.header_.request() == Request::HeartBeat && (utility::time_in_ms() - time_since_last_package) < kHeartBeatInterval) {
-        continue;
-      }
-      time_since_last_package = utility::time_in_ms();
-
-      package.header_.SetSeqenceNr(sequence_nr_reliable);
-      sequence_nr_reliable++;
-      if (sliding_window.size() == kWindowSize) {
-        sliding_window.pop_back();
-      }
-      sliding_window.push_front(package);
+    if (Channel::Unreliable == outgoing_package.channel()) {
+      progress_pending = true;
+    } else {
+      Send(outgoing_package.package_);
+    }
+  }
+}
 
-      ReliablePackage reliable_package(client.host_name(), sliding_window.size());
+#if defined(__linux__)
 
-      std::copy(std::begin(sliding_window), std::end(sliding_window), reliable_package.package_.packages_);
-      client.Send(&reliable_package, sizeof(reliable_package));
-    } else {
-      auto& package = outgoing_package.progress_package_;
+// Receives, sends and runs the timers on one thread. The reactor is woken by the eventfd when a package is queued and
+// by the timerfd at the next heartbeat or liveness check.
+void MultiPlayerController::RunReactor() {
+  auto arm_timer = [this] {
+    reactor_->SetTimer(std::min(timers_.next_deadline(), utility::time_in_ms() + kLivenessResolution));
+  };
 
-      package.header_.SetSeqenceNr(sequence_nr_unreliable);
-      sequence_nr_unreliable++;
+  reactor_->Watch(listener_->file_descriptor(), [this] {
+    for (;;) {
+      const auto size = listener_->Poll(0);
 
-      UnreliablePackage unreliable_package(client.host_name(), package);
+      if (SOCKET_ERROR == size) {
+        reactor_->Stop();
+        break;
+      }
+      if (SOCKET_TIMEOUT == size) {
+        break;
+      }
+    }
+  });
+  reactor_->OnWake([this, arm_timer] {
+    OutgoingPackage outgoing_package;
+    bool progress_pending = false;
 
-      client.Send(&unreliable_package, sizeof(unreliable_package));
+    while (send_queue_->Pop(outgoing_package, std::chrono::milliseconds(0))) {
+      if (Channel::None == outgoing_package.channel()) {
+        reactor_->Stop();
+        break;
+      }
+      if (Channel::Unreliable == outgoing_package.channel()) {
+        progress_pending = true;
+      } else {
+        Send(outgoing_package.package_);
+      }
     }
-  }
+    if (progress_pending) {
+      SendProgressUpdates();
+    }
+    arm_timer();
+  });
+  reactor_->OnTimer([this, arm_timer] {
+    HandleTimers();
+    listener_->TerminateTimedOutConnections();
+    arm_timer();
+  });
+  arm_timer();
+  reactor_->Run();
 }
 
+#endif
+
 } // namespace network
@@ -1,6 +1,12 @@
 #pragma once
 
 #include "network/listener.h"
+#include "network/matrix_state_codec.h"
+#include "network/reactor.h"
+#include "network/sliding_window.h"
+#include "utility/timer_wheel.h"
+
+#include <map>
 
 namespace network {
 
@@ -20,11 +26,20 @@ class ListenerInterface {
 
   virtual void GotProgressUpdate(uint64_t host_id, int lines, int score, int level, const MatrixState&) = 0;
 
+  virtual void GotProgressUpdate(uint64_t host_id, int lines, int score, int level, const PieceState&) = 0;
+
+  virtual void GotSeed(uint64_t host_id, uint64_t seed) = 0;
+
+  virtual void GotInput(uint64_t host_id, const InputEvent& input) = 0;
+
   virtual void GotLines(uint64_t host_id, int lines) = 0;
 
   virtual void GotPlayerKnockedOut(uint64_t host_id) = 0;
 };
 
+// Send the operations that changes the matrix instead of the matrix (COMBATRIS_INPUT_STREAM=1)
+bool UseInputStream();
+
 class MultiPlayerController {
  public:
   struct OutgoingPackage {
@@ -32,17 +47,23 @@ class MultiPlayerController {
 
     OutgoingPackage(const Package& package) : package_(package), channel_(Channel::Reliable) {}
 
-    OutgoingPackage(const ProgressPackage& package) : progress_package_(package), channel_(Channel::Unreliable ) {}
+    // Progress updates are kept aside in the latest progress slots, the queue only tells that there are updates to send
+    explicit OutgoingPackage(Channel channel) : channel_(channel) {}
 
     inline Channel channel() const { return channel_; }
 
     Package package_;
-    ProgressPackage progress_package_;
     Channel channel_;
   };
 
   MultiPlayerController(ListenerInterface* listener);
 
+  // Sends and receives through the given transports instead of UDP sockets
+  MultiPlayerController(ListenerInterface* listener, std::unique_ptr<Transmitter> transmitter, std::unique_ptr<Receiver> receiver);
+
+  // Bring-up may block on DNS lookups, so a controller is usually created on a thread of its own. A controller that
+  // failed to start can only be destroyed.
+
   ~MultiPlayerController() noexcept;
 
   void Join(network::GameState state = GameState::Idle);
@@ -61,15 +82,34 @@ class MultiPlayerController {
 
   void SendUpdate(int lines, int score, int level, const MatrixState& state);
 
+  void SendUpdate(int lines, int score, int level, const PieceState& piece);
+
+  void SendUpdate(const InputEvent& input);
+
+  void SendSeed(uint64_t seed);
+
   void Dispatch();
 
   inline bool IsUs(uint64_t host_id) const { return host_id == our_host_id_; }
 
+  inline bool GetConnectionStats(uint64_t host_id, ConnectionStats& stats) const {
+    return listener_ && listener_->GetConnectionStats(host_id, stats);
+  }
+
   inline const std::string& our_host_name() const { return our_host_name_; }
 
+  // Set if the sockets couldn't be opened, or receiving or the reactor failed later on
+  bool has_failed() const;
+
+  std::string error() const;
+
  protected:
   void Run();
 
+#if defined(__linux__)
+  void RunReactor();
+#endif
+
   void Wait() {
     if (!send_thread_) {
       return;
@@ -77,32 +117,48 @@ class MultiPlayerController {
     if (send_thread_->joinable()) {
       send_thread_->join();
     }
-    if (heartbeat_thread_) {
-      if (heartbeat_thread_->joinable()) {
-        heartbeat_thread_->join();
-      }
-    }
   }
 
-  void Cancel() noexcept {
-    if (!send_thread_ || cancelled_.load(std::memory_order_acquire)) {
-      return;
-    }
-    cancelled_.store(true, std::memory_order_release);
-    listener_->Cancel();
-    send_queue_->Cancel();
+  // Everything queued before the call is sent before the threads stop
+  void Stop() noexcept {
+    Enqueue(OutgoingPackage());
     Wait();
+    listener_->Cancel();
   }
 
  private:
-  uint64_t our_host_id_;
+  enum class Timer { HeartBeat };
+
+  void Enqueue(OutgoingPackage package);
+
+  void EnqueueProgress(const ProgressPackage& package);
+
+  void Send(Package& package);
+
+  void Send(ProgressPackage& package);
+
+  void SendProgressUpdates();
+
+  void HandleTimers();
+
+  uint64_t our_host_id_ = 0;
   std::string our_host_name_;
-  std::atomic<bool> cancelled_;
+  std::string error_;
   ListenerInterface* listener_if_;
+  std::unique_ptr<Transmitter> transmitter_;
   std::unique_ptr<Listener> listener_;
   std::shared_ptr<ThreadSafeQueue<OutgoingPackage>> send_queue_;
+  std::mutex progress_mutex_;
+  std::map<MatrixEncoding, ProgressPackage> latest_progress_;
+  SlidingWindow sliding_window_;
+  MatrixStateEncoder matrix_state_encoder_;
+  uint32_t sequence_nr_unreliable_ = 0;
+  utility::TimerWheel<Timer> timers_;
+  bool joined_ = false;
+#if defined(__linux__)
+  std::unique_ptr<Reactor> reactor_;
+#endif
   std::unique_ptr<std::thread> send_thread_;
-  std::unique_ptr<std::thread> heartbeat_thread_;
 };
 
 } // namespace network
@@ -0,0 +1,130 @@
+#include "network/network_interfaces.h"
+#include "network/udp_client_server.h"
+
+#if defined(_WIN64)
+
+#include <ws2tcpip.h>
+
+#else
+
+#include <arpa/inet.h>
+#include <ifaddrs.h>
+#include <net/if.h>
+#include <netinet/in.h>
+
+#endif
+
+#include <algorithm>
+#include <iostream>
+
+namespace network {
+
+namespace {
+
+bool IsValidAddress(uint32_t ip) {
+  auto c = (ip >> 24) & 0xFF;
+
+  return (c != 169 && c != 127);
+}
+
+std::string ToString(uint32_t ip) {
+  in_addr addr{};
+  char buffer[INET_ADDRSTRLEN];
+
+  addr.s_addr = htonl(ip);
+
+  return inet_ntop(AF_INET, &addr, buffer, sizeof(buffer)) != nullptr ? buffer : "";
+}
+
+void Add(std::vector<NetworkInterface>& interfaces, const std::string& name, uint32_t ip, uint32_t netmask) {
+  const auto broadcast_address = ToString(ip | ~netmask);
+
+  if (std::any_of(interfaces.begin(), interfaces.end(), [&](const auto& i) { return i.broadcast_address_ == broadcast_address; })) {
+    return;
+  }
+  interfaces.push_back(NetworkInterface{ name, ToString(ip), broadcast_address, netmask });
+}
+
+#if defined(_WIN64)
+
+// The addresses of the host name, the netmask isn't known so a /24 network is assumed
+std::vector<NetworkInterface> FindNetworkInterfaces() {
+  const uint32_t kNetmask = 0xFFFFFF00;
+  std::vector<NetworkInterface> interfaces;
+  addrinfo hints{};
+
+  hints.ai_family = AF_INET;
+  hints.ai_socktype = SOCK_DGRAM;
+  hints.ai_protocol = IPPROTO_UDP;
+
+  addrinfo* addrs = nullptr;
+  auto ret_val = getaddrinfo(GetHostName().c_str(), nullptr, &hints, &addrs);
+
+  if (ret_val != 0) {
+    std::cout << "getaddrinfo failed with error: " << ret_val << std::endl;
+    return interfaces;
+  }
+  for (auto addr = addrs; addr != nullptr; addr = addr->ai_next) {
+    if (AF_INET == addr->ai_family) {
+      const auto ip = ntohl(reinterpret_cast<sockaddr_in*>(addr->ai_addr)->sin_addr.S_un.S_addr);
+
+      if (IsValidAddress(ip)) {
+        Add(interfaces, "", ip, kNetmask);
+      }
+    }
+  }
+  freeaddrinfo(addrs);
+
+  return interfaces;
+}
+
+#else
+
+std::vector<NetworkInterface> FindNetworkInterfaces() {
+  std::vector<NetworkInterface> interfaces;
+  ifaddrs* addrs = nullptr;
+
+  if (getifaddrs(&addrs) < 0) {
+    std::cout << "getifaddrs failed" << std::endl;
+    return interfaces;
+  }
+  for (auto addr = addrs; addr != nullptr; addr = addr->ifa_next) {
+    if (nullptr == addr->ifa_addr || nullptr == addr->ifa_netmask || addr->ifa_addr->sa_family != AF_INET) {
+      continue;
+    }
+    if ((addr->ifa_flags & IFF_UP) == 0 || (addr->ifa_flags & IFF_BROADCAST) == 0 || (addr->ifa_flags & IFF_LOOPBACK) != 0) {
+      continue;
+    }
+    const auto ip = ntohl(reinterpret_cast<sockaddr_in*>(addr->ifa_addr)->sin_addr.s_addr);
+    const auto netmask = ntohl(reinterpret_cast<sockaddr_in*>(addr->ifa_netmask)->sin_addr.s_addr);
+
+    if (IsValidAddress(ip)) {
+      Add(interfaces, addr->ifa_name, ip, netmask);
+    }
+  }
+  freeifaddrs(addrs);
+
+  return interfaces;
+}
+
+#endif
+
+} // namespace
+
+const std::vector<NetworkInterface>& GetNetworkInterfaces() {
+  static const auto interfaces = [] {
+    auto interfaces = FindNetworkInterfaces();
+
+    if (interfaces.size() > 1) {
+      std::cout << "Several network interfaces found, set COMBATRIS_ALL_INTERFACES=1 to broadcast on all of them" << std::endl;
+      for (const auto& i : interfaces) {
+        std::cout << "  " << i.name_ << " " << i.address_ << ", broadcast " << i.broadcast_address_ << std::endl;
+      }
+    }
+    return interfaces;
+  }();
+
+  return interfaces;
+}
+
+} // namespace network
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace network {
+
+// IPv4 interface that is up and can broadcast, loopback and link-local interfaces are left out
+struct NetworkInterface {
+  std::string name_;
+  std::string address_;
+  std::string broadcast_address_;
+  uint32_t netmask_ = 0;
+};
+
+// The interfaces are enumerated on the first call and kept for the lifetime of the process, interfaces with the same
+// broadcast address (aliases on the same network) are only listed once
+const std::vector<NetworkInterface>& GetNetworkInterfaces();
+
+} // namespace network
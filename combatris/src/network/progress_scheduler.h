@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+
+namespace network {
+
+// Decides when the next progress update is sent. A change the other players should see right away (a tetromino is
+// locked or lines are received) is sent after the minimum interval, other changes after the regular interval and
+// nothing is sent if nothing has changed. The updates are broadcast to all players, so the intervals are stretched
+// by the slowest or most lossy connection.
+class ProgressScheduler final {
+ public:
+  // Time in seconds
+  static constexpr double kMinInterval = 0.050;
+  static constexpr double kRegularInterval = 0.100;
+  static constexpr double kMaxScale = 4.0;
+
+  void Changed(bool urgent) {
+    changed_ = true;
+    urgent_ = urgent_ || urgent;
+  }
+
+  bool IsDue(double now) const {
+    if (!changed_) {
+      return false;
+    }
+    return now - sent_at_ >= (urgent_ ? kMinInterval : kRegularInterval) * scale_;
+  }
+
+  void Sent(double now) {
+    sent_at_ = now;
+    changed_ = urgent_ = false;
+  }
+
+  // Round-trip time in ms and the fraction of datagrams lost, 100 ms or 10% loss doubles the intervals
+  void SetConnectionQuality(double rtt, double loss) {
+    scale_ = std::clamp(std::max(rtt / kTargetRtt, 1.0) * (1.0 + loss * kLossPenalty), 1.0, kMaxScale);
+  }
+
+  inline double scale() const { return scale_; }
+
+ private:
+  static constexpr double kTargetRtt = 50.0;
+  static constexpr double kLossPenalty = 10.0;
+
+  double sent_at_ = 0.0;
+  double scale_ = 1.0;
+  bool changed_ = false;
+  bool urgent_ = false;
+};
+
+} // namespace network
@@ -37,6 +37,8 @@ inline uint64_t ntohll(uint64_t value) {
 #endif
 
 #include <string>
+#include <string_view>
+#include <cstring>
 #include <array>
 #include <iostream>
 #include <functional>
@@ -68,7 +70,7 @@ inline uint64_t SetHostName(const std::string& from, char *to) {
   return std::hash<std::string>{}(from);
 }
 
-enum Request : uint8_t { Empty, Join, Leave, NewGame, StartGame, NewState, SendLines, KnockedOutBy, ProgressUpdate, HeartBeat };
+enum Request : uint8_t { Empty, Join, Leave, NewGame, StartGame, NewState, SendLines, KnockedOutBy, ProgressUpdate, HeartBeat, Seed, Input };
 
 inline std::string ToString(Request request) {
   switch (request) {
@@ -92,6 +94,10 @@ inline std::string ToString(Request request) {
       return "Request::ProgressUpdate";
     case Request::HeartBeat:
       return "Request::Heartbeat";
+    case Request::Seed:
+      return "Request::Seed";
+    case Request::Input:
+      return "Request::Input";
   }
   return "Unknown";
 }
@@ -116,6 +122,64 @@ inline std::string ToString(GameState state) {
 
 enum class Channel : uint8_t { None, Unreliable, Reliable };
 
+// Input stream, an operation that changes the matrix packed into the 64 bit value of a Request::Input package. The
+// receiver replays the operations to get an exact copy of the matrix, the board hash is used to verify the copy.
+//
+// Bits 60-63 type, Lock: 56-59 tetromino, 54-55 angle, 49-53 row, 45-48 col, 42-44 latest move
+//                  Garbage: 32-39 lines
+//                  BoardHash: 32-59 number of operations
+// Bits 0-31 time in ms since the game started (BoardHash: hash of the matrix)
+class InputEvent final {
+ public:
+  enum class Type : uint8_t { None, Lock, Garbage, KnockedOut, BoardHash };
+
+  InputEvent() = default;
+
+  explicit InputEvent(uint64_t value) : value_(value) {}
+
+  static InputEvent Lock(int tetromino, int angle, int row, int col, int latest_move, uint32_t time) {
+    return InputEvent(Type::Lock, Field(tetromino, 56, 4) | Field(angle, 54, 2) | Field(row, 49, 5) | Field(col, 45, 4) |
+                      Field(latest_move, 42, 3) | time);
+  }
+
+  static InputEvent Garbage(int lines, uint32_t time) { return InputEvent(Type::Garbage, Field(lines, 32, 8) | time); }
+
+  static InputEvent KnockedOut(uint32_t time) { return InputEvent(Type::KnockedOut, time); }
+
+  static InputEvent BoardHash(uint32_t operations, uint32_t hash) { return InputEvent(Type::BoardHash, Field(operations, 32, 28) | hash); }
+
+  inline uint64_t value() const { return value_; }
+
+  inline Type type() const { return static_cast<Type>(Get(60, 4)); }
+
+  inline int tetromino() const { return static_cast<int>(Get(56, 4)); }
+
+  inline int angle() const { return static_cast<int>(Get(54, 2)); }
+
+  inline int row() const { return static_cast<int>(Get(49, 5)); }
+
+  inline int col() const { return static_cast<int>(Get(45, 4)); }
+
+  inline int latest_move() const { return static_cast<int>(Get(42, 3)); }
+
+  inline int lines() const { return static_cast<int>(Get(32, 8)); }
+
+  inline uint32_t operations() const { return static_cast<uint32_t>(Get(32, 28)); }
+
+  inline uint32_t time() const { return static_cast<uint32_t>(Get(0, 32)); }
+
+  inline uint32_t hash() const { return static_cast<uint32_t>(Get(0, 32)); }
+
+ private:
+  InputEvent(Type type, uint64_t value) : value_(Field(static_cast<uint64_t>(type), 60, 4) | value) {}
+
+  static uint64_t Field(uint64_t value, int shift, int bits) { return (value & ((uint64_t(1) << bits) - 1)) << shift; }
+
+  uint64_t Get(int shift, int bits) const { return (value_ >> shift) & ((uint64_t(1) << bits) - 1); }
+
+  uint64_t value_ = 0;
+};
+
 #pragma pack(push, 1)
 
 class Header final {
@@ -144,21 +208,43 @@ class Header final {
   Request request_;
 };
 
+enum class MatrixEncoding : uint8_t { None, KeyFrame, Delta, Piece };
+
+// The tetromino in play, sent instead of the matrix when the input stream is used
+struct PieceState {
+  uint8_t type_ = 0;
+  uint8_t angle_ = 0;
+  uint8_t row_ = 0;
+  uint8_t col_ = 0;
+};
+
 class ProgressPayload final {
  public:
-  ProgressPayload() : score_(0), lines_(0), level_(0) {}
+  ProgressPayload() : score_(0), lines_(0), level_(0), encoding_(MatrixEncoding::None), key_frame_(0), size_(0) {}
 
   ProgressPayload(uint16_t lines, uint32_t score, uint8_t level) {
     lines_ = htons(lines);
     score_ = htonl(score);
     level_ = level;
+    SetMatrixData(MatrixEncoding::None, 0, 0);
   }
 
   ProgressPayload(uint16_t lines, uint32_t score, uint8_t level, const MatrixState& matrix_state) {
     lines_ = htons(lines);
     score_ = htonl(score);
     level_ = level;
-    std::copy(matrix_state.begin(), matrix_state.end(), matrix_state_);
+    SetMatrixState(0, matrix_state);
+  }
+
+  ProgressPayload(uint16_t lines, uint32_t score, uint8_t level, const PieceState& piece) {
+    lines_ = htons(lines);
+    score_ = htonl(score);
+    level_ = level;
+    data_[0] = piece.type_;
+    data_[1] = piece.angle_;
+    data_[2] = piece.row_;
+    data_[3] = piece.col_;
+    SetMatrixData(MatrixEncoding::Piece, 0, sizeof(PieceState));
   }
 
   inline uint16_t lines() const { return ntohs(lines_); }
@@ -167,11 +253,38 @@ class ProgressPayload final {
 
   inline uint8_t level() const { return level_; }
 
+  inline MatrixEncoding encoding() const { return encoding_; }
+
+  inline uint16_t key_frame() const { return ntohs(key_frame_); }
+
+  inline int size() const { return size_; }
+
+  inline const uint8_t* data() const { return data_; }
+
+  inline uint8_t* data() { return data_; }
+
+  // Number of bytes at the end of the payload that are not in use and don't have to be sent
+  inline size_t unused_size() const { return sizeof(data_) - std::min<size_t>(size_, sizeof(data_)); }
+
+  void SetMatrixData(MatrixEncoding encoding, uint16_t key_frame, uint8_t size) {
+    encoding_ = encoding;
+    key_frame_ = htons(key_frame);
+    size_ = size;
+  }
+
+  void SetMatrixState(uint16_t key_frame, const MatrixState& matrix_state) {
+    static_assert(sizeof(MatrixState::value_type) == 1);
+    std::copy(matrix_state.begin(), matrix_state.end(), data_);
+    SetMatrixData(MatrixEncoding::KeyFrame, key_frame, kMatrixStateSize);
+  }
+
+  PieceState piece() const { return PieceState{ data_[0], data_[1], data_[2], data_[3] }; }
+
+  // Only valid for key frames, delta frames has to be decoded by a MatrixStateDecoder
   MatrixState matrix_state() const {
     MatrixState matrix_state;
 
-    static_assert(sizeof(MatrixState::value_type) == 1);
-    std::copy(matrix_state_, matrix_state_ + kMatrixStateSize, matrix_state.begin());
+    std::copy(data_, data_ + kMatrixStateSize, matrix_state.begin());
 
     return matrix_state;
   }
@@ -180,7 +293,10 @@ class ProgressPayload final {
   uint32_t score_;
   uint16_t lines_;
   uint8_t level_;
-  MatrixState::value_type matrix_state_[kMatrixStateSize];
+  MatrixEncoding encoding_;
+  uint16_t key_frame_;
+  uint8_t size_;
+  uint8_t data_[kMatrixStateSize];
 };
 
 class Payload final {
@@ -214,7 +330,10 @@ class PackageHeader final {
     host_name_[0] = '\0';
   }
 
-  inline std::string host_name() const { return host_name_; }
+  inline std::string host_name() const { return std::string(host_name_view()); }
+
+  // Doesn't rely on the name being null terminated, it's read straight out of the receive buffer
+  inline std::string_view host_name_view() const { return std::string_view(host_name_, strnlen(host_name_, sizeof(host_name_))); }
 
   inline void SetHostName(const std::string& name) { host_id_ = network::SetHostName(name, host_name_); }
 
@@ -242,6 +361,8 @@ struct UnreliablePackage {
     header_.SetHostName(host_name);
   }
 
+  inline size_t size() const { return sizeof(UnreliablePackage) - package_.payload_.unused_size(); }
+
   PackageHeader header_ = PackageHeader(Channel::Unreliable);
   ProgressPackage package_;
 };
@@ -262,6 +383,35 @@ struct PackageArray {
   uint8_t size_;
 };
 
+// Send time of the datagram and the send time of the latest datagram received from one of the other players, echoed
+// back together with the time it was held before the echo. The times are in ms and truncated to 32 bits.
+class TimeStamps final {
+ public:
+  TimeStamps() : send_time_(0), echo_host_id_(0), echo_time_(0), echo_delay_(0) {}
+
+  explicit TimeStamps(uint32_t send_time) : send_time_(htonl(send_time)), echo_host_id_(0), echo_time_(0), echo_delay_(0) {}
+
+  inline uint32_t send_time() const { return ntohl(send_time_); }
+
+  inline uint64_t echo_host_id() const { return echo_host_id_; }
+
+  inline uint32_t echo_time() const { return ntohl(echo_time_); }
+
+  inline uint32_t echo_delay() const { return ntohl(echo_delay_); }
+
+  inline void SetEcho(uint64_t host_id, uint32_t time, uint32_t delay) {
+    echo_host_id_ = host_id;
+    echo_time_ = htonl(time);
+    echo_delay_ = htonl(delay);
+  }
+
+ private:
+  uint32_t send_time_;
+  uint64_t echo_host_id_;
+  uint32_t echo_time_;
+  uint32_t echo_delay_;
+};
+
 struct ReliablePackage {
   ReliablePackage() : package_(0) {}
 
@@ -275,6 +425,7 @@ struct ReliablePackage {
   inline bool Verify() const { return header_.Verify(); }
 
   PackageHeader header_ = PackageHeader(Channel::Reliable);
+  TimeStamps time_stamps_;
   PackageArray package_;
 };
 
@@ -313,6 +464,15 @@ inline auto CreatePackage(uint16_t lines, uint32_t score, uint8_t level) {
   return package;
 }
 
+inline auto CreatePackage(uint16_t lines, uint32_t score, uint8_t level, const PieceState& piece) {
+  ProgressPackage package;
+
+  package.header_ = Header(Request::ProgressUpdate);
+  package.payload_ = ProgressPayload(lines, score, level, piece);
+
+  return package;
+}
+
 inline auto CreatePackage(uint16_t lines, uint32_t score, uint8_t level, const MatrixState& state) {
   ProgressPackage package;
 
@@ -4,4 +4,5 @@ const int kWaitForIncomingPackages = 500;
 const int kHeartBeatInterval = 200;
 const int64_t kConnectionTimeOut = 5000;
 const int64_t kConnectionMissing = 2500;
-const int64_t kConnectionCheckAliveInterval = 1000;
+const int64_t kLivenessResolution = 100;
+const size_t kLivenessSlots = 64;
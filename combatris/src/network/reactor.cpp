@@ -0,0 +1,126 @@
+#include "network/reactor.h"
+
+#if defined(__linux__)
+
+#include "utility/timer.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include <algorithm>
+#include <iostream>
+
+namespace network {
+
+namespace {
+
+const int kMaxEvents = 16;
+
+void Drain(int fd) {
+  uint64_t value;
+
+  if (read(fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+    std::cout << "Reactor: read failed - " << strerror(errno) << std::endl;
+  }
+}
+
+} // namespace
+
+Reactor::Reactor() {
+  epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+  event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+  timer_fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  if (epoll_fd_ < 0 || event_fd_ < 0 || timer_fd_ < 0) {
+    Fail("create");
+    return;
+  }
+  Watch(event_fd_, [this] {
+    Drain(event_fd_);
+    if (on_wake_) {
+      on_wake_();
+    }
+  });
+  Watch(timer_fd_, [this] {
+    Drain(timer_fd_);
+    if (on_timer_) {
+      on_timer_();
+    }
+  });
+}
+
+// The first failure is kept, the error is read by other threads once the flag is set
+void Reactor::Fail(const std::string& what) {
+  Stop();
+  if (has_failed()) {
+    return;
+  }
+  error_ = "Reactor: " + what + " failed - " + strerror(errno);
+  std::cout << error_ << std::endl;
+  failed_.store(true, std::memory_order_release);
+}
+
+Reactor::~Reactor() noexcept {
+  for (auto fd : { timer_fd_, event_fd_, epoll_fd_ }) {
+    if (fd >= 0) {
+      close(fd);
+    }
+  }
+}
+
+void Reactor::Watch(int fd, std::function<void()> on_readable) {
+  epoll_event event{};
+
+  event.events = EPOLLIN;
+  event.data.fd = fd;
+  if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+    Fail("epoll_ctl");
+    return;
+  }
+  on_readable_[fd] = on_readable;
+}
+
+void Reactor::Wake() {
+  const uint64_t value = 1;
+
+  if (write(event_fd_, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+    std::cout << "Reactor: write failed - " << strerror(errno) << std::endl;
+  }
+}
+
+void Reactor::SetTimer(int64_t deadline) {
+  const auto wait = std::max<int64_t>(1, deadline - utility::time_in_ms());
+  itimerspec timer{};
+
+  timer.it_value.tv_sec = wait / 1000;
+  timer.it_value.tv_nsec = (wait % 1000) * 1000000;
+  if (timerfd_settime(timer_fd_, 0, &timer, nullptr) < 0) {
+    Fail("timerfd_settime");
+  }
+}
+
+void Reactor::Run() {
+  epoll_event events[kMaxEvents];
+
+  while (!stopped_) {
+    const auto count = epoll_wait(epoll_fd_, events, kMaxEvents, -1);
+
+    if (count < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      Fail("epoll_wait");
+      break;
+    }
+    for (int i = 0; i < count && !stopped_; ++i) {
+      on_readable_.at(events[i].data.fd)();
+    }
+  }
+}
+
+} // namespace network
+
+#endif
@@ -0,0 +1,63 @@
+#pragma once
+
+#if defined(__linux__)
+
+#include <atomic>
+#include <functional>
+#include <string>
+#include <unordered_map>
+
+namespace network {
+
+// Single threaded event loop on top of epoll, an eventfd wakes the loop from other threads and a timerfd expires at
+// the time set with SetTimer
+class Reactor final {
+ public:
+  Reactor();
+
+  Reactor(const Reactor&) = delete;
+
+  ~Reactor() noexcept;
+
+  inline bool is_open() const { return epoll_fd_ >= 0 && event_fd_ >= 0 && timer_fd_ >= 0 && !has_failed(); }
+
+  // Set when a system call failed, the loop is stopped. Thread safe
+  inline bool has_failed() const { return failed_.load(std::memory_order_acquire); }
+
+  // Valid once has_failed returns true
+  inline const std::string& error() const { return error_; }
+
+  void Watch(int fd, std::function<void()> on_readable);
+
+  inline void OnWake(std::function<void()> on_wake) { on_wake_ = on_wake; }
+
+  inline void OnTimer(std::function<void()> on_timer) { on_timer_ = on_timer; }
+
+  // Thread safe
+  void Wake();
+
+  // Time in ms, as utility::time_in_ms
+  void SetTimer(int64_t deadline);
+
+  // Runs the callbacks until one of them calls Stop
+  void Run();
+
+  inline void Stop() { stopped_ = true; }
+
+ private:
+  void Fail(const std::string& what);
+
+  int epoll_fd_;
+  int event_fd_;
+  int timer_fd_;
+  bool stopped_ = false;
+  std::string error_;
+  std::atomic<bool> failed_ = false;
+  std::function<void()> on_wake_;
+  std::function<void()> on_timer_;
+  std::unordered_map<int, std::function<void()>> on_readable_;
+};
+
+} // namespace network
+
+#endif
@@ -0,0 +1,200 @@
+#include "network/session_capture.h"
+
+#if defined(_WIN64)
+
+#include <process.h>
+
+#else
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#endif
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+namespace network {
+
+namespace {
+
+const std::string kEnvCapture = "COMBATRIS_CAPTURE";
+const uint32_t kCaptureSignature = 0x43434150; // CCAP
+const uint32_t kCaptureVersion = 1;
+const int64_t kFlushInterval = 1000000;
+
+int64_t time_in_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+std::string GetCaptureFile() {
+  auto env = getenv(kEnvCapture.c_str());
+
+  return (nullptr == env) ? "" : env;
+}
+
+std::string GetSessionCaptureFile(const std::string& file_name) {
+  static std::atomic<int> sessions(0);
+#if defined(_WIN64)
+  const auto pid = _getpid();
+#else
+  const auto pid = getpid();
+#endif
+
+  return file_name + "." + std::to_string(pid) + "." + std::to_string(++sessions);
+}
+
+SessionCapture::SessionCapture(const std::string& file_name) : file_(std::fopen(file_name.c_str(), "wb")) {
+  if (nullptr == file_) {
+    std::cout << "Failed to open capture file \"" << file_name << "\"" << std::endl;
+    return;
+  }
+  const CaptureFileHeader header{ kCaptureSignature, kCaptureVersion };
+
+  std::fwrite(&header, sizeof(header), 1, file_);
+  std::cout << "Capturing received datagrams to \"" << file_name << "\"" << std::endl;
+}
+
+SessionCapture::~SessionCapture() noexcept {
+  if (nullptr != file_) {
+    std::fclose(file_);
+  }
+}
+
+// The file is flushed about once a second, so a capture survives a crash but for the last second
+void SessionCapture::Write(const void* buff, size_t size) {
+  if (nullptr == file_) {
+    return;
+  }
+  const auto now = time_in_us();
+  const CaptureRecord record{ now, static_cast<uint32_t>(size) };
+
+  std::fwrite(&record, sizeof(record), 1, file_);
+  std::fwrite(buff, 1, size, file_);
+  if (now - flushed_at_ >= kFlushInterval) {
+    std::fflush(file_);
+    flushed_at_ = now;
+  }
+}
+
+#if defined(_WIN64)
+
+SessionCaptureReader::SessionCaptureReader(const std::string& file_name) {
+  std::ifstream file(file_name, std::ios::binary);
+
+  if (!file) {
+    std::cout << "Failed to open capture file \"" << file_name << "\"" << std::endl;
+    return;
+  }
+  buffer_.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  data_ = buffer_.data();
+  size_ = buffer_.size();
+  Rewind();
+}
+
+SessionCaptureReader::~SessionCaptureReader() noexcept {}
+
+#else
+
+SessionCaptureReader::SessionCaptureReader(const std::string& file_name) {
+  auto fd = open(file_name.c_str(), O_RDONLY);
+
+  if (fd < 0) {
+    std::cout << "Failed to open capture file \"" << file_name << "\"" << std::endl;
+    return;
+  }
+  struct stat file_stat;
+
+  if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+    auto data = mmap(nullptr, static_cast<size_t>(file_stat.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+
+    if (data != MAP_FAILED) {
+      data_ = static_cast<const char*>(data);
+      size_ = static_cast<size_t>(file_stat.st_size);
+    }
+  }
+  close(fd);
+  Rewind();
+}
+
+SessionCaptureReader::~SessionCaptureReader() noexcept {
+  if (nullptr != data_) {
+    munmap(const_cast<char*>(data_), size_);
+  }
+}
+
+#endif
+
+void SessionCaptureReader::Rewind() {
+  offset_ = sizeof(CaptureFileHeader);
+  if (nullptr == data_) {
+    return;
+  }
+  CaptureFileHeader header;
+
+  if (size_ < sizeof(header)) {
+    offset_ = size_;
+    return;
+  }
+  std::copy(data_, data_ + sizeof(header), reinterpret_cast<char*>(&header));
+  if (header.signature_ != kCaptureSignature || header.version_ != kCaptureVersion) {
+    std::cout << "Unknown capture file format" << std::endl;
+    offset_ = size_;
+  }
+}
+
+bool SessionCaptureReader::Next(CaptureRecord& record, const char*& data) {
+  if (nullptr == data_ || size_ - offset_ < sizeof(record)) {
+    return false;
+  }
+  std::copy(data_ + offset_, data_ + offset_ + sizeof(record), reinterpret_cast<char*>(&record));
+  if (size_ - offset_ - sizeof(record) < record.size_) {
+    return false;
+  }
+  data = data_ + offset_ + sizeof(record);
+  offset_ += sizeof(record) + record.size_;
+
+  return true;
+}
+
+ssize_t CaptureReceiver::Receive(void* buff, size_t max_size, int max_wait_ms) {
+  const auto max_wait = std::chrono::milliseconds(max_wait_ms);
+
+  if (!has_pending_) {
+    if (!reader_.Next(pending_, pending_data_)) {
+      finished_.store(true, std::memory_order_release);
+      std::this_thread::sleep_for(max_wait);
+      return SOCKET_TIMEOUT;
+    }
+    if (datagrams_replayed() == 0) {
+      first_time_ = pending_.time_;
+      started_at_ = Clock::now();
+    }
+    has_pending_ = true;
+  }
+  if (original_speed_) {
+    const auto due = started_at_ + std::chrono::microseconds(pending_.time_ - first_time_);
+    const auto deadline = Clock::now() + max_wait;
+
+    std::this_thread::sleep_until(std::min(due, deadline));
+    if (due > deadline) {
+      return SOCKET_TIMEOUT;
+    }
+  }
+  has_pending_ = false;
+
+  const auto size = std::min<size_t>(pending_.size_, max_size);
+
+  std::copy(pending_data_, pending_data_ + size, static_cast<char*>(buff));
+  datagrams_replayed_.fetch_add(1, std::memory_order_relaxed);
+
+  return static_cast<ssize_t>(size);
+}
+
+} // namespace network
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "network/transport.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace network {
+
+// Capture every datagram received to the given file (COMBATRIS_CAPTURE=<file>), empty if not set
+std::string GetCaptureFile();
+
+// Every session is captured to a file of its own, the name is suffixed with the process id and the session number,
+// e.g. "combatris.cap.4711.1", so a session never replaces an earlier capture
+std::string GetSessionCaptureFile(const std::string& file_name);
+
+#pragma pack(push, 1)
+
+// A capture file is the header followed by one record per datagram, each record is followed by the datagram. The
+// fields are in host byte order, captures are replayed on the machine they were taken on or a machine like it.
+struct CaptureFileHeader {
+  uint32_t signature_;
+  uint32_t version_;
+};
+
+struct CaptureRecord {
+  int64_t time_; // us, steady clock
+  uint32_t size_;
+};
+
+#pragma pack(pop)
+
+// Writes the datagrams received to a new capture file
+class SessionCapture final {
+ public:
+  explicit SessionCapture(const std::string& file_name);
+
+  SessionCapture(const SessionCapture&) = delete;
+
+  ~SessionCapture() noexcept;
+
+  inline bool is_open() const { return nullptr != file_; }
+
+  void Write(const void* buff, size_t size);
+
+ private:
+  std::FILE* file_ = nullptr;
+  int64_t flushed_at_ = 0;
+};
+
+// Read only view of a capture file, the file is mapped into memory where supported. A record cut short at the end of
+// the file (the game crashed while writing it) ends the capture.
+class SessionCaptureReader final {
+ public:
+  explicit SessionCaptureReader(const std::string& file_name);
+
+  SessionCaptureReader(const SessionCaptureReader&) = delete;
+
+  ~SessionCaptureReader() noexcept;
+
+  inline bool is_open() const { return nullptr != data_; }
+
+  // Returns false at the end of the capture, data points into the mapped file
+  bool Next(CaptureRecord& record, const char*& data);
+
+  void Rewind();
+
+ private:
+  const char* data_ = nullptr;
+  size_t size_ = 0;
+  size_t offset_ = 0;
+  std::vector<char> buffer_;
+};
+
+// Replays a capture as if the datagrams were received again, either with the original time between them or as fast as
+// they are asked for
+class CaptureReceiver final : public Receiver {
+ public:
+  CaptureReceiver(const std::string& file_name, bool original_speed)
+      : reader_(file_name), original_speed_(original_speed), finished_(!reader_.is_open()) {}
+
+  virtual ssize_t Receive(void* buff, size_t max_size, int max_wait_ms) override;
+
+  inline bool is_open() const { return reader_.is_open(); }
+
+  // Set when asked for a datagram after the last one, by then the last one has been handled
+  inline bool finished() const { return finished_.load(std::memory_order_acquire); }
+
+  inline uint64_t datagrams_replayed() const { return datagrams_replayed_.load(std::memory_order_relaxed); }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  SessionCaptureReader reader_;
+  bool original_speed_;
+  std::atomic<bool> finished_;
+  std::atomic<uint64_t> datagrams_replayed_{0};
+  bool has_pending_ = false;
+  CaptureRecord pending_ = {};
+  const char* pending_data_ = nullptr;
+  int64_t first_time_ = 0;
+  Clock::time_point started_at_;
+};
+
+} // namespace network
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "network/protocol.h"
+
+#include <algorithm>
+#include <deque>
+
+namespace network {
+
+// Every reliable datagram carries the latest kWindowSize packages, so a package is only lost if kWindowSize datagrams
+// in a row are lost
+class SlidingWindow final {
+ public:
+  ReliablePackage Push(const std::string& host_name, Package package) {
+    package.header_.SetSeqenceNr(sequence_nr_);
+    sequence_nr_++;
+    if (window_.size() == kWindowSize) {
+      window_.pop_back();
+    }
+    window_.push_front(package);
+
+    ReliablePackage reliable_package(host_name, static_cast<uint8_t>(window_.size()));
+
+    std::copy(std::begin(window_), std::end(window_), reliable_package.package_.packages_);
+
+    return reliable_package;
+  }
+
+ private:
+  uint32_t sequence_nr_ = 0;
+  std::deque<Package> window_;
+};
+
+} // namespace network
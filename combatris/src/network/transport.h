@@ -0,0 +1,41 @@
+#pragma once
+
+#if defined(_WIN64)
+#include <BaseTsd.h>
+
+using ssize_t = SSIZE_T;
+
+#else
+
+#include <sys/types.h>
+
+#endif
+
+#include <string>
+
+namespace network {
+
+const int SOCKET_TIMEOUT = -2;
+
+// Sending end of a datagram transport, i.e. UDPClient or an in-process loopback
+class Transmitter {
+ public:
+  virtual ~Transmitter() noexcept {}
+
+  virtual ssize_t Send(const void* buff, size_t size) = 0;
+
+  virtual const std::string& host_name() const = 0;
+};
+
+// Receiving end of a datagram transport, returns the size of the datagram, SOCKET_TIMEOUT or SOCKET_ERROR
+class Receiver {
+ public:
+  virtual ~Receiver() noexcept {}
+
+  virtual ssize_t Receive(void* buff, size_t max_size, int max_wait_ms) = 0;
+
+  // The file descriptor to wait on with poll/epoll, -1 if there is none
+  virtual int file_descriptor() const { return -1; }
+};
+
+} // namespace network
@@ -1,5 +1,6 @@
 #include "network/protocol.h"
 #include "network/udp_client_server.h"
+#include "network/network_interfaces.h"
 
 #if defined(_WIN64)
 
@@ -23,13 +24,18 @@
 #include <sys/types.h>
 
 #include <iostream>
+#include <algorithm>
 
 namespace {
 
 const std::string kEnvServer = "COMBATRIS_BROADCAST_IP";
 const std::string kEnvPort = "COMBATRIS_BROADCAST_PORT";
+const std::string kEnvMulticastGroup = "COMBATRIS_MULTICAST_GROUP";
+const std::string kEnvMulticastTTL = "COMBATRIS_MULTICAST_TTL";
+const std::string kEnvAllInterfaces = "COMBATRIS_ALL_INTERFACES";
 const std::string kDefaultBroadcastIP = "192.168.1.255";
 const int kDefaultPort = 11000;
+const int kDefaultMulticastTTL = 1;
 
 #if defined(_WIN64)
 
@@ -68,84 +74,83 @@ unsigned& GetAddressAsUnsigned(in_addr& addr) { return addr.s_addr; }
 const int kPortLowerRange = 1024;
 const int kPortUpperRange = 49151;
 
-void Exit() {
-  network::Cleanup();
-  exit(-1);
+// Prints the error and keeps it for the caller to report
+bool Fail(const std::string& message, std::string& error) {
+  std::cout << message << std::endl;
+  error = message;
+
+  return false;
 }
 
-void EnableBroadcast(const std::string& name, SOCKET socket) {
+bool EnableBroadcast(const std::string& name, SOCKET socket, std::string& error) {
   int enable_broadcast = 1;
 
   if (setsockopt(socket, SOL_SOCKET, SO_BROADCAST, reinterpret_cast<char*>(&enable_broadcast), sizeof(enable_broadcast)) < 0) {
-    std::cout << name << ": setsockopt failed - " << get_error_string(get_last_error()) << std::endl;
-    Exit();
+    return Fail(name + ": setsockopt failed - " + get_error_string(get_last_error()), error);
   }
+  return true;
 }
 
-void SetCloseOnExit(const std::string& name, SOCKET socket) {
-#if !defined(_WIN64)
-  if (fcntl(socket, F_SETFD, FD_CLOEXEC) < 0) {
-    std::cout << name << ": fcntl failed - " << get_error_string(get_last_error()) << std::endl;
-    Exit();
-  }
-#endif
-}
+bool IsMulticastAddress(const std::string& address) {
+  in_addr addr{};
 
-void VerifyAddressAndPort(const std::string& broadcast_address, int port) {
-  if (broadcast_address.empty()) {
-    std::cout << "Server Broadcast Broadcast_Addressess cannot be empty" << std::endl;
-    Exit();
-  }
-  if (port < kPortLowerRange || port > kPortUpperRange) {
-    std::cout << "Invalid port (" << kPortLowerRange << " <= " << port << " <= " << kPortUpperRange << std::endl;
-    Exit();
+  if (inet_pton(AF_INET, address.c_str(), &addr) != 1) {
+    return false;
   }
+  return IN_MULTICAST(ntohl(GetAddressAsUnsigned(addr)));
 }
 
-bool IsValidAddress(unsigned ip) {
-  auto c = (ip >> 24) & 0xFF;
+bool SetMulticastOptions(const std::string& name, SOCKET socket, int ttl, std::string& error) {
+  // Windows expects a DWORD for the multicast options, a BSD socket an unsigned char (Linux accepts both)
+#if defined(_WIN64)
+  DWORD multicast_ttl = ttl;
+  DWORD multicast_loop = 1;
+#else
+  unsigned char multicast_ttl = static_cast<unsigned char>(ttl);
+  unsigned char multicast_loop = 1;
+#endif
 
-  return (c != 169 && c != 127);
+  if (setsockopt(socket, IPPROTO_IP, IP_MULTICAST_TTL, reinterpret_cast<char*>(&multicast_ttl), sizeof(multicast_ttl)) < 0 ||
+      setsockopt(socket, IPPROTO_IP, IP_MULTICAST_LOOP, reinterpret_cast<char*>(&multicast_loop), sizeof(multicast_loop)) < 0) {
+    return Fail(name + ": setsockopt failed - " + get_error_string(get_last_error()), error);
+  }
+  return true;
 }
 
-// Handles IP4 addresses only
-std::string FindBroadcastAddress() {
-  addrinfo hints{};
-
-  hints.ai_family = AF_INET;
-  hints.ai_socktype = SOCK_DGRAM;
-  hints.ai_protocol = IPPROTO_UDP;
-
-  addrinfo* addrs = nullptr;
+bool SetMulticastMembership(const std::string& name, SOCKET socket, const std::string& group, int option) {
+  ip_mreq request{};
 
-  auto ret_val = getaddrinfo(network::GetHostName().c_str(), nullptr, &hints, &addrs);
+  if (inet_pton(AF_INET, group.c_str(), &request.imr_multiaddr) != 1) {
+    std::cout << name << ": invalid multicast group - \"" << group << "\"" << std::endl;
+    return false;
+  }
+  GetAddressAsUnsigned(request.imr_interface) = htonl(INADDR_ANY);
 
-  if (ret_val != 0) {
-    std::cout << "getaddrinfo failed with error: " << get_error_string(ret_val) << std::endl;
-    return kDefaultBroadcastIP;
+  if (setsockopt(socket, IPPROTO_IP, option, reinterpret_cast<char*>(&request), sizeof(request)) < 0) {
+    std::cout << name << ": setsockopt failed - " << get_error_string(get_last_error()) << std::endl;
+    return false;
   }
-  auto address = kDefaultBroadcastIP;
+  return true;
+}
 
-  for (auto addr = addrs; addr != nullptr; addr = addr->ai_next) {
-    if (AF_INET == addrs->ai_family) {
-      auto sockaddr_ipv4 = reinterpret_cast<sockaddr_in*>(addr->ai_addr);
-      auto ip = ntohl(GetAddressAsUnsigned(sockaddr_ipv4->sin_addr));
+bool SetCloseOnExit(const std::string& name, SOCKET socket, std::string& error) {
+#if !defined(_WIN64)
+  if (fcntl(socket, F_SETFD, FD_CLOEXEC) < 0) {
+    return Fail(name + ": fcntl failed - " + get_error_string(get_last_error()), error);
+  }
+#endif
+  return true;
+}
 
-      if (IsValidAddress(ip)) {
-        if (address != kDefaultBroadcastIP) {
-          std::cout << "Warning - several network interfaces found" << std::endl;
-          break;
-        }
-        GetAddressAsUnsigned(sockaddr_ipv4->sin_addr) = htonl(ip | 0xFF);
-        address = inet_ntoa(sockaddr_ipv4->sin_addr);
-      }
-    }
+bool VerifyAddressAndPort(const std::string& broadcast_address, int port, std::string& error) {
+  if (broadcast_address.empty()) {
+    return Fail("Broadcast address cannot be empty", error);
   }
-  if (addrs != nullptr) {
-    freeaddrinfo(addrs);
+  if (port < kPortLowerRange || port > kPortUpperRange) {
+    return Fail("Invalid port (" + std::to_string(kPortLowerRange) + " <= " + std::to_string(port) + " <= " +
+                std::to_string(kPortUpperRange) + ")", error);
   }
-
-  return address;
+  return true;
 }
 
 } // namespace
@@ -153,8 +158,10 @@ std::string FindBroadcastAddress() {
 namespace network {
 
 UDPClient::UDPClient(const std::string& broadcast_address, int port) {
-  VerifyAddressAndPort(broadcast_address, port);
-
+  host_name_ = GetHostName();
+  if (!VerifyAddressAndPort(broadcast_address, port, error_)) {
+    return;
+  }
   addrinfo hints{};
 
   hints.ai_family = AF_UNSPEC;
@@ -164,24 +171,27 @@ UDPClient::UDPClient(const std::string& broadcast_address, int port) {
   auto ret_value(getaddrinfo(broadcast_address.c_str(), std::to_string(port).c_str(), &hints, &addr_info_));
 
   if (ret_value != 0 || nullptr == addr_info_) {
-    std::cout << "UDPClient: "
-              << "invalid address or port - \"" << broadcast_address << ":" << port << "\"" << std::endl;
-    std::cout << "UDPClient: error message - " << get_error_string(get_last_error()) << std::endl;
-    Cleanup();
-    Exit();
+    Fail("UDPClient: invalid address or port - \"" + broadcast_address + ":" + std::to_string(port) + "\" - " +
+         get_error_string(get_last_error()), error_);
+    return;
   }
 
   socket_ = socket(addr_info_->ai_family, addr_info_->ai_socktype, addr_info_->ai_protocol);
 
   if (socket_ < 0) {
-    std::cout << "UDPClient: could not create socket for -  \"" << broadcast_address << ":" << port << "\"" << std::endl;
-    std::cout << "UDPClient: error message - " << get_error_string(get_last_error()) << std::endl;
-    Exit();
+    Fail("UDPClient: could not create socket for - \"" + broadcast_address + ":" + std::to_string(port) + "\" - " +
+         get_error_string(get_last_error()), error_);
+    socket_ = INVALID_SOCKET;
+    return;
+  }
+  if (!SetCloseOnExit("UDPClient", socket_, error_)) {
+    return;
+  }
+  if (IsMulticastAddress(broadcast_address)) {
+    SetMulticastOptions("UDPClient", socket_, GetMulticastTTL(), error_);
+  } else {
+    EnableBroadcast("UDPClient", socket_, error_);
   }
-  SetCloseOnExit("UDPClient", socket_);
-  EnableBroadcast("UDPClient", socket_);
-
-  host_name_ = GetHostName();
 }
 
 UDPClient::~UDPClient() noexcept {
@@ -193,8 +203,8 @@ UDPClient::~UDPClient() noexcept {
   }
 }
 
-ssize_t UDPClient::Send(void* buff, size_t size) {
-  auto ret_value = sendto(socket_, static_cast<char*>(buff), size, 0, addr_info_->ai_addr, addr_info_->ai_addrlen);
+ssize_t UDPClient::Send(const void* buff, size_t size) {
+  auto ret_value = sendto(socket_, static_cast<const char*>(buff), size, 0, addr_info_->ai_addr, addr_info_->ai_addrlen);
 
   if (ret_value == -1) {
     std::cout << "UDPClient::Send error message: " << get_error_string(get_last_error()) << std::endl;
@@ -203,10 +213,33 @@ ssize_t UDPClient::Send(void* buff, size_t size) {
   return ret_value;
 }
 
-UDPServer::UDPServer(int port) {
+MultiInterfaceClient::MultiInterfaceClient(const std::vector<std::string>& broadcast_addresses, int port) {
+  for (const auto& broadcast_address : broadcast_addresses) {
+    clients_.push_back(std::make_unique<UDPClient>(broadcast_address, port));
+    if (!clients_.back()->is_open()) {
+      error_ = clients_.back()->error();
+      break;
+    }
+  }
+  host_name_ = GetHostName();
+}
+
+ssize_t MultiInterfaceClient::Send(const void* buff, size_t size) {
+  ssize_t ret_value = SOCKET_ERROR;
+
+  for (auto& client : clients_) {
+    ret_value = std::max(ret_value, client->Send(buff, size));
+  }
+  return ret_value;
+}
+
+UDPServer::UDPServer(int port, const std::string& multicast_group) {
   const std::string kBroadcastAddress = "0.0.0.0";
 
-  VerifyAddressAndPort(kBroadcastAddress, port);
+  host_name_ = GetHostName();
+  if (!VerifyAddressAndPort(kBroadcastAddress, port, error_)) {
+    return;
+  }
   addrinfo hints{};
 
   hints.ai_family = AF_UNSPEC;
@@ -216,30 +249,40 @@ UDPServer::UDPServer(int port) {
   auto ret_value(getaddrinfo(kBroadcastAddress.c_str(), std::to_string(port).c_str(), &hints, &addr_info_));
 
   if (ret_value != 0 || nullptr == addr_info_) {
-    std::cout << "UDPServer: " << "invalid address or port - \"" << kBroadcastAddress << ":" << port << "\"" << std::endl;
-    std::cout << "UDPServer: error message - " << get_error_string(get_last_error()) << std::endl;
-    Exit();
+    Fail("UDPServer: invalid address or port - \"" + kBroadcastAddress + ":" + std::to_string(port) + "\" - " +
+         get_error_string(get_last_error()), error_);
+    return;
   }
   socket_ = socket(addr_info_->ai_family, addr_info_->ai_socktype, addr_info_->ai_protocol);
 
   if (socket_ == INVALID_SOCKET) {
-    std::cout << "UDPServer: could not create socket for - \"" << kBroadcastAddress << ":" << port << "\"" << std::endl;
-    std::cout << "UDPServer: error message: - " << get_error_string(get_last_error()) << std::endl;
-    Exit();
+    Fail("UDPServer: could not create socket for - \"" + kBroadcastAddress + ":" + std::to_string(port) + "\" - " +
+         get_error_string(get_last_error()), error_);
+    return;
+  }
+  if (!SetCloseOnExit("UDPServer", socket_, error_) || !EnableBroadcast("UDPServer", socket_, error_)) {
+    return;
   }
-  SetCloseOnExit("UDPServer", socket_);
-  EnableBroadcast("UDPServer", socket_);
-
   ret_value = bind(socket_, addr_info_->ai_addr, addr_info_->ai_addrlen);
 
   if (ret_value != 0) {
-    std::cout << "UDPServer: could not bind socket with - \"" << kBroadcastAddress << ":" << port << "\" " << std::endl;
-    std::cout << "UDPServer: error message - " << get_error_string(get_last_error()) << std::endl;
+    Fail("UDPServer: could not bind socket with - \"" + kBroadcastAddress + ":" + std::to_string(port) + "\" - " +
+         get_error_string(get_last_error()), error_);
+    return;
+  }
+  if (!multicast_group.empty()) {
+    if (!SetMulticastMembership("UDPServer", socket_, multicast_group, IP_ADD_MEMBERSHIP)) {
+      error_ = "UDPServer: could not join multicast group - \"" + multicast_group + "\"";
+      return;
+    }
+    multicast_group_ = multicast_group;
   }
-  host_name_ = GetHostName();
 }
 
 UDPServer::~UDPServer() noexcept {
+  if (!multicast_group_.empty()) {
+    SetMulticastMembership("UDPServer", socket_, multicast_group_, IP_DROP_MEMBERSHIP);
+  }
   if (addr_info_ != nullptr) {
     freeaddrinfo(addr_info_);
   }
@@ -301,6 +344,16 @@ ssize_t UDPServer::Receive(void* buff, size_t max_size, sockaddr_in& from_addr,
   return SOCKET_TIMEOUT;
 }
 
+ssize_t UDPServer::Send(const void* buff, size_t size, const sockaddr_in& to_addr) {
+  auto ret_value = sendto(socket_, static_cast<const char*>(buff), size, 0, reinterpret_cast<const sockaddr*>(&to_addr), sizeof(to_addr));
+
+  if (ret_value == -1) {
+    std::cout << "UDPServer::Send error message: " << get_error_string(get_last_error()) << std::endl;
+  }
+
+  return ret_value;
+}
+
 std::string GetHostName() {
   char host_name[network::kHostNameMax + 1];
 
@@ -315,11 +368,53 @@ std::string GetBroadcastAddress() {
   auto env = getenv(kEnvServer.c_str());
 
   if (nullptr == env) {
-    return FindBroadcastAddress();
+    const auto& interfaces = GetNetworkInterfaces();
+
+    return interfaces.empty() ? kDefaultBroadcastIP : interfaces.front().broadcast_address_;
   }
   return env;
 }
 
+bool BroadcastOnAllInterfaces() {
+  auto env = getenv(kEnvAllInterfaces.c_str());
+
+  if (nullptr == env || std::string(env) == "0") {
+    return false;
+  }
+  return nullptr == getenv(kEnvServer.c_str()) && GetMulticastGroup().empty() && GetNetworkInterfaces().size() > 1;
+}
+
+std::string GetMulticastGroup() {
+  auto env = getenv(kEnvMulticastGroup.c_str());
+
+  if (nullptr == env) {
+    return "";
+  }
+  if (!IsMulticastAddress(env)) {
+    std::cout << "Invalid multicast group (224.0.0.0 - 239.255.255.255) - \"" << env << "\", broadcast is used" << std::endl;
+    return "";
+  }
+  return env;
+}
+
+int GetMulticastTTL() {
+  auto env = getenv(kEnvMulticastTTL.c_str());
+
+  if (nullptr == env) {
+    return kDefaultMulticastTTL;
+  }
+  return std::clamp(std::stoi(env), 1, 255);
+}
+
+std::string GetDestinationAddress() {
+  auto multicast_group = GetMulticastGroup();
+
+  if (multicast_group.empty()) {
+    return GetBroadcastAddress();
+  }
+  return multicast_group;
+}
+
 int GetPort() {
   auto env = getenv(kEnvPort.c_str());
 
@@ -331,22 +426,23 @@ int GetPort() {
 
 #if defined(_WIN64)
 
-void Startup() {
+bool Startup() {
   WSADATA wsaData;
 
   auto error_code = WSAStartup(MAKEWORD(2, 2), &wsaData);
 
   if (error_code != 0) {
     std::cout << "WSAStartup failed with error: " + get_error_string(error_code) << std::endl;
-    Exit();
+    return false;
   }
+  return true;
 }
 
 void Cleanup() { WSACleanup(); }
 
 #else
 
-void Startup() {}
+bool Startup() { return true; }
 
 void Cleanup() {}
 
@@ -4,9 +4,6 @@
 #define NOMINMAX
 #define WIN32_LEAN_AND_MEAN
 #include <winsock2.h>
-#include <BaseTsd.h>
-
-using ssize_t = SSIZE_T;
 
 #else
 
@@ -19,59 +16,112 @@ const int SOCKET_ERROR = -1;
 
 #endif
 
+#include "network/transport.h"
+
+#include <memory>
 #include <string>
+#include <vector>
 
 namespace network {
 
-const int SOCKET_TIMEOUT = -2;
-
-class UDPClient {
+class UDPClient final : public Transmitter {
  public:
   UDPClient(const std::string& broadcast_address, int port);
 
   UDPClient(const UDPClient&) = delete;
 
-  ~UDPClient() noexcept;
+  virtual ~UDPClient() noexcept;
 
-  ssize_t Send(void* buff, size_t size);
+  virtual ssize_t Send(const void* buff, size_t size) override;
 
-  const std::string& host_name() const { return host_name_; }
+  virtual const std::string& host_name() const override { return host_name_; }
+
+  inline bool is_open() const { return error_.empty(); }
+
+  inline const std::string& error() const { return error_; }
 
  private:
   SOCKET socket_ = INVALID_SOCKET;
   addrinfo* addr_info_ = nullptr;
   std::string host_name_;
+  std::string error_;
+};
+
+// Sends every datagram to each of the broadcast addresses, for hosts with several network interfaces. A broadcast
+// address is routed out on the interface of its network.
+class MultiInterfaceClient final : public Transmitter {
+ public:
+  MultiInterfaceClient(const std::vector<std::string>& broadcast_addresses, int port);
+
+  MultiInterfaceClient(const MultiInterfaceClient&) = delete;
+
+  virtual ssize_t Send(const void* buff, size_t size) override;
+
+  virtual const std::string& host_name() const override { return host_name_; }
+
+  inline bool is_open() const { return error_.empty(); }
+
+  inline const std::string& error() const { return error_; }
+
+ private:
+  std::vector<std::unique_ptr<UDPClient>> clients_;
+  std::string host_name_;
+  std::string error_;
 };
 
-class UDPServer {
+class UDPServer final : public Receiver {
  public:
-  explicit UDPServer(int port);
+  explicit UDPServer(int port, const std::string& multicast_group = "");
 
   UDPServer(const UDPServer&) = delete;
 
-  ~UDPServer() noexcept;
+  virtual ~UDPServer() noexcept;
 
   ssize_t Receive(void* buff, size_t max_size) { return recv(socket_, static_cast<char*>(buff), static_cast<int>(max_size), 0); }
 
-  ssize_t Receive(void* buff, size_t max_size, int max_wait_ms);
+  virtual ssize_t Receive(void* buff, size_t max_size, int max_wait_ms) override;
 
   ssize_t Receive(void* buff, size_t max_size, sockaddr_in& from_addr, int max_wait_ms);
 
+  ssize_t Send(const void* buff, size_t size, const sockaddr_in& to_addr);
+
+#if !defined(_WIN64)
+  virtual int file_descriptor() const override { return socket_; }
+#endif
+
   const std::string& host_name() const { return host_name_; }
 
+  inline bool is_open() const { return error_.empty(); }
+
+  inline const std::string& error() const { return error_; }
+
  private:
   SOCKET socket_ = INVALID_SOCKET;
   addrinfo* addr_info_ = nullptr;
   std::string host_name_;
+  std::string multicast_group_;
+  std::string error_;
 };
 
 std::string GetHostName();
 
 std::string GetBroadcastAddress();
 
+std::string GetMulticastGroup();
+
+// Broadcast on every network interface (COMBATRIS_ALL_INTERFACES=1), only when there are several interfaces and
+// neither multicast nor a fixed broadcast address is used
+bool BroadcastOnAllInterfaces();
+
+int GetMulticastTTL();
+
+// The multicast group if multicast is enabled, otherwise the broadcast address
+std::string GetDestinationAddress();
+
 int GetPort();
 
-void Startup();
+// Returns false if the network stack couldn't be initialized
+bool Startup();
 
 void Cleanup();
 
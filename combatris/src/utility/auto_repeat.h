@@ -0,0 +1,48 @@
+#pragma once
+
+#include <chrono>
+
+namespace utility {
+
+// Delayed auto shift and auto repeat rate of a held control. The repeats are generated at the times they are scheduled
+// for, as many as are due, so the rate doesn't depend on how often Run is called.
+class AutoRepeat final {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  AutoRepeat(Clock::duration initial_delay, Clock::duration subsequent_delay)
+      : initial_delay_(initial_delay), subsequent_delay_(subsequent_delay) {}
+
+  // The first repeat is the press itself
+  void Press(Clock::time_point at) {
+    active_ = true;
+    next_ = at;
+    count_ = 0;
+  }
+
+  inline void Release() { active_ = false; }
+
+  inline bool active() const { return active_; }
+
+  inline bool IsDue(Clock::time_point now) const { return active_ && next_ <= now; }
+
+  // Calls func with the scheduled time of each repeat due at now, in order
+  template<typename Func>
+  void Run(Clock::time_point now, Func func) {
+    while (IsDue(now)) {
+      const auto at = next_;
+
+      next_ += (0 == count_++) ? initial_delay_ : subsequent_delay_;
+      func(at);
+    }
+  }
+
+ private:
+  Clock::duration initial_delay_;
+  Clock::duration subsequent_delay_;
+  bool active_ = false;
+  Clock::time_point next_;
+  int count_ = 0;
+};
+
+} // namespace utility
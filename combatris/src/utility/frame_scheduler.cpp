@@ -0,0 +1,74 @@
+#include "utility/frame_scheduler.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+namespace {
+
+const std::string kEnvFrameRate = "COMBATRIS_FPS";
+const std::string kEnvVsync = "COMBATRIS_VSYNC";
+
+const auto kSleepSlice = std::chrono::milliseconds(2);
+const auto kSpinTime = std::chrono::microseconds(1500);
+
+std::chrono::steady_clock::duration ToInterval(int fps) {
+  if (fps <= 0) {
+    return std::chrono::steady_clock::duration::zero();
+  }
+  return std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(1.0 / fps));
+}
+
+} // namespace
+
+namespace utility {
+
+int GetFrameRate(int default_fps) {
+  auto env = getenv(kEnvFrameRate.c_str());
+
+  if (nullptr == env) {
+    return default_fps;
+  }
+  return std::max(std::atoi(env), 0);
+}
+
+bool UseVsync() {
+  auto env = getenv(kEnvVsync.c_str());
+
+  return nullptr != env && std::string(env) != "0";
+}
+
+FrameScheduler::FrameScheduler(int fps, int idle_fps, Now now, Sleep sleep)
+    : now_(now ? now : Clock::now),
+      sleep_(sleep ? sleep : [](Clock::duration duration) { std::this_thread::sleep_for(duration); }),
+      interval_(ToInterval(fps)), idle_interval_(ToInterval(idle_fps)), last_frame_(now_()) {
+  if (interval_ > Clock::duration::zero()) {
+    idle_interval_ = std::max(idle_interval_, interval_);
+  }
+}
+
+bool FrameScheduler::Wait(bool idle, const std::function<bool()>& interrupted) {
+  const auto interval = idle ? idle_interval_ : interval_;
+  const auto deadline = last_frame_ + interval;
+  auto now = now_();
+
+  while (now < deadline) {
+    const auto time_left = deadline - now;
+
+    if (time_left > kSpinTime) {
+      if (interrupted && interrupted()) {
+        return false;
+      }
+      sleep_(std::min<Clock::duration>(time_left - kSpinTime, kSleepSlice));
+    } else {
+      std::this_thread::yield();
+    }
+    now = now_();
+  }
+  last_frame_ = (now - deadline > interval) ? now : deadline;
+
+  return true;
+}
+
+} // namespace utility
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+namespace utility {
+
+// Frames per second from COMBATRIS_FPS, default_fps if not set, 0 is not limited
+int GetFrameRate(int default_fps);
+
+// Presents wait for the vertical blank when COMBATRIS_VSYNC is set and not 0
+bool UseVsync();
+
+// Paces the main loop to a target frame rate, or to a low rate while the game is idle. The time left to the next frame
+// is slept away in short slices and the last part is spun, a sleep overshoots by up to a millisecond or more.
+class FrameScheduler final {
+ public:
+  using Clock = std::chrono::steady_clock;
+  using Now = std::function<Clock::time_point()>;
+  using Sleep = std::function<void(Clock::duration)>;
+
+  // The clock and the sleep are replaced by a test, the defaults are the steady clock and sleeping the thread
+  FrameScheduler(int fps, int idle_fps, Now now = nullptr, Sleep sleep = nullptr);
+
+  // Returns true at the next frame, or false as soon as interrupted returns true and the frame keeps its deadline. A
+  // frame that is late by more than one interval starts the next interval from now, the lost time is not caught up.
+  bool Wait(bool idle, const std::function<bool()>& interrupted = nullptr);
+
+ private:
+  Now now_;
+  Sleep sleep_;
+  Clock::duration interval_;
+  Clock::duration idle_interval_;
+  Clock::time_point last_frame_;
+};
+
+} // namespace utility
@@ -0,0 +1,126 @@
+#include "utility/glyph_atlas.h"
+
+#include <algorithm>
+
+namespace {
+
+using namespace utility;
+
+const int kMaxAtlasWidth = 1024;
+const int kPadding = 1;
+
+} // namespace
+
+namespace utility {
+
+GlyphAtlas::GlyphAtlas(Renderer* renderer, TTF_Font* font) : renderer_(renderer), font_(font) {
+  if (nullptr == font_) {
+    return;
+  }
+  height_ = TTF_FontHeight(font_);
+
+  std::vector<UniqueSurfacePtr> surfaces;
+  int x = 0;
+  int y = 0;
+  int row_height = 0;
+
+  // The glyphs are rendered in white and tinted when drawn, rows wrap at the max width of the atlas
+  for (int ch = kFirstGlyph; ch <= kLastGlyph; ++ch) {
+    auto& glyph = glyphs_[ch - kFirstGlyph];
+    int minx = 0, maxx = 0, miny = 0, maxy = 0;
+
+    TTF_GlyphMetrics(font_, static_cast<Uint16>(ch), &minx, &maxx, &miny, &maxy, &glyph.advance_);
+    // The surface of a glyph starts at the left most pixel of the glyph, which is left of the pen for some glyphs
+    glyph.offset_x_ = std::min(0, minx);
+    surfaces.emplace_back(TTF_RenderGlyph_Blended(font_, static_cast<Uint16>(ch), GetColor(Color::White)));
+
+    const auto& surface = surfaces.back();
+
+    if (!surface) {
+      continue;
+    }
+    if (x + surface->w > kMaxAtlasWidth) {
+      x = 0;
+      y += row_height + kPadding;
+      row_height = 0;
+    }
+    glyph.rc_ = { x, y, surface->w, surface->h };
+    x += surface->w + kPadding;
+    row_height = std::max(row_height, surface->h);
+    texture_width_ = std::max(texture_width_, x);
+  }
+  texture_height_ = y + row_height;
+  if (0 == texture_width_ || 0 == texture_height_) {
+    return;
+  }
+  auto atlas = UniqueSurfacePtr(SDL_CreateRGBSurfaceWithFormat(0, texture_width_, texture_height_, 32, SDL_PIXELFORMAT_ARGB8888));
+
+  if (!atlas || nullptr == renderer_) {
+    return;
+  }
+  for (int ch = kFirstGlyph; ch <= kLastGlyph; ++ch) {
+    const auto& surface = surfaces[ch - kFirstGlyph];
+
+    if (!surface) {
+      continue;
+    }
+    SDL_Rect rc = glyphs_[ch - kFirstGlyph].rc_;
+
+    SDL_SetSurfaceBlendMode(surface.get(), SDL_BLENDMODE_NONE);
+    SDL_BlitSurface(surface.get(), nullptr, atlas.get(), &rc);
+  }
+  texture_ = renderer_->CreateTextureFromSurface(std::move(atlas));
+  renderer_->SetTextureBlendMode(texture_.get(), SDL_BLENDMODE_BLEND);
+}
+
+int GlyphAtlas::Kerning(char previous, char ch) const {
+#if SDL_TTF_VERSION_ATLEAST(2, 0, 14)
+  if (0 != previous) {
+    return TTF_GetFontKerningSizeGlyphs(font_, static_cast<Uint16>(previous), static_cast<Uint16>(ch));
+  }
+#else
+  (void)previous;
+  (void)ch;
+#endif
+  return 0;
+}
+
+int GlyphAtlas::Width(std::string_view text) const {
+  int x = 0;
+  int width = 0;
+  char previous = 0;
+
+  for (auto ch : text) {
+    if (!InAtlas(ch)) {
+      continue;
+    }
+    const auto& g = glyph(ch);
+
+    x += Kerning(previous, ch);
+    width = std::max(width, x + g.offset_x_ + g.rc_.w);
+    x += g.advance_;
+    previous = ch;
+  }
+  return width;
+}
+
+void GlyphAtlas::Add(int x, int y, std::string_view text, Color color, uint8_t alpha) {
+  const auto c = GetColor(color, alpha);
+  char previous = 0;
+
+  for (auto ch : text) {
+    if (!InAtlas(ch)) {
+      continue;
+    }
+    const auto& g = glyph(ch);
+
+    x += Kerning(previous, ch);
+    if (g.rc_.w > 0) {
+      batch_.Add(g.rc_, { x + g.offset_x_, y, g.rc_.w, g.rc_.h }, c);
+    }
+    x += g.advance_;
+    previous = ch;
+  }
+}
+
+} // namespace utility
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "utility/text.h"
+#include "utility/quad_batch.h"
+
+#include <array>
+#include <string_view>
+
+namespace utility {
+
+// The printable ASCII glyphs of a font rasterised once into one texture. Text is drawn as one quad per glyph from the
+// cached metrics, changing the text costs no surface or texture allocation.
+class GlyphAtlas final {
+ public:
+  GlyphAtlas(Renderer* renderer, TTF_Font* font);
+
+  GlyphAtlas(const GlyphAtlas&) = delete;
+
+  // Width of the text as drawn, characters outside the atlas are skipped
+  int Width(std::string_view text) const;
+
+  inline int height() const { return height_; }
+
+  // Queues the text, the queued text is drawn by Flush
+  void Add(int x, int y, std::string_view text, Color color, uint8_t alpha = 255);
+
+  inline void Flush() { batch_.Flush(renderer_, texture_.get(), texture_width_, texture_height_); }
+
+  void Render(int x, int y, std::string_view text, Color color, uint8_t alpha = 255) {
+    Add(x, y, text, color, alpha);
+    Flush();
+  }
+
+ private:
+  static const int kFirstGlyph = 32;
+  static const int kLastGlyph = 126;
+
+  struct Glyph {
+    SDL_Rect rc_ = { 0, 0, 0, 0 }; // In the atlas
+    int offset_x_ = 0;
+    int advance_ = 0;
+  };
+
+  inline static bool InAtlas(char ch) { return ch >= kFirstGlyph && ch <= kLastGlyph; }
+
+  inline const Glyph& glyph(char ch) const { return glyphs_[ch - kFirstGlyph]; }
+
+  int Kerning(char previous, char ch) const;
+
+  Renderer* renderer_;
+  TTF_Font* font_;
+  UniqueTexturePtr texture_ = nullptr;
+  int texture_width_ = 0;
+  int texture_height_ = 0;
+  int height_ = 0;
+  std::array<Glyph, kLastGlyph - kFirstGlyph + 1> glyphs_;
+  QuadBatch batch_;
+};
+
+} // namespace utility
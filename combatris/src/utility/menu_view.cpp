@@ -11,7 +11,7 @@ const Font kFontItem = Font(Font::Typeface::ObelixPro, Font::Emphasis::Normal, 1
 
 namespace utility {
 
-MenuView::MenuView(SDL_Renderer* renderer, const SDL_Rect& rc, const std::shared_ptr<Fonts>& fonts,
+MenuView::MenuView(Renderer* renderer, const SDL_Rect& rc, const std::shared_ptr<Fonts>& fonts,
                    const std::shared_ptr<MenuModel>& menu_model, MenuAction* menu_action)
     : renderer_(renderer), rc_(rc), fonts_(fonts), menu_model_(menu_model), selected_item_(menu_model->GetSelected()), menu_action_(menu_action) {
   menu_model_->SetActionListener(this);
@@ -40,13 +40,13 @@ void MenuView::Render() {
       auto& left = selection_.at(Left);
       left->rc_.x = item->rc_.x - (left->rc_.w + 10);
       left->rc_.y = offset;
-      SDL_RenderCopy(renderer_, left->texture_.get(), nullptr, &left->rc_);
+      renderer_->Copy(left->texture_.get(), nullptr, &left->rc_);
       auto& right = selection_.at(Right);
       right->rc_.x = item->rc_.x + (item->rc_.w + 10);
       right->rc_.y = offset;
-      SDL_RenderCopy(renderer_, right->texture_.get(), nullptr, &right->rc_);
+      renderer_->Copy(right->texture_.get(), nullptr, &right->rc_);
     }
-    SDL_RenderCopy(renderer_, item->texture_.get(), nullptr, &item->rc_);
+    renderer_->Copy(item->texture_.get(), nullptr, &item->rc_);
     offset += item->rc_.h + ((MenuModel::MenuItemType::Name == item->type_) ? 10 : 25);
     pos++;
   }
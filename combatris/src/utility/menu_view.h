@@ -8,7 +8,7 @@ namespace utility {
 
 class MenuView : protected MenuAction {
  public:
-  MenuView(SDL_Renderer* renderer, const SDL_Rect& rc, const std::shared_ptr<Fonts>& fonts,
+  MenuView(Renderer* renderer, const SDL_Rect& rc, const std::shared_ptr<Fonts>& fonts,
            const std::shared_ptr<MenuModel>& menu_model, MenuAction* menu_action);
 
   virtual ~MenuView() noexcept {}
@@ -39,7 +39,7 @@ class MenuView : protected MenuAction {
   std::shared_ptr<MenuItem> CreateItem(size_t item);
 
  private:
-  SDL_Renderer* renderer_;
+  Renderer* renderer_;
   SDL_Rect rc_;
   std::shared_ptr<Fonts> fonts_;
   std::vector<std::shared_ptr<Selection>> selection_;
@@ -0,0 +1,48 @@
+#include "utility/quad_batch.h"
+
+namespace utility {
+
+void QuadBatch::Flush(Renderer* renderer, Texture* texture, int texture_width, int texture_height) {
+  if (nullptr == texture || quads_.empty()) {
+    quads_.clear();
+    return;
+  }
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  const float w = static_cast<float>(texture_width);
+  const float h = static_cast<float>(texture_height);
+
+  vertices_.clear();
+  indices_.clear();
+  for (const auto& quad : quads_) {
+    const auto& src = quad.src_;
+    const auto& dst = quad.dst_;
+    const auto index = static_cast<int>(vertices_.size());
+    const float u0 = src.x / w, v0 = src.y / h, u1 = (src.x + src.w) / w, v1 = (src.y + src.h) / h;
+    const float x0 = static_cast<float>(dst.x), y0 = static_cast<float>(dst.y);
+    const float x1 = static_cast<float>(dst.x + dst.w), y1 = static_cast<float>(dst.y + dst.h);
+
+    vertices_.push_back({ { x0, y0 }, quad.color_, { u0, v0 } });
+    vertices_.push_back({ { x1, y0 }, quad.color_, { u1, v0 } });
+    vertices_.push_back({ { x1, y1 }, quad.color_, { u1, v1 } });
+    vertices_.push_back({ { x0, y1 }, quad.color_, { u0, v1 } });
+    for (auto i : { 0, 1, 2, 0, 2, 3 }) {
+      indices_.push_back(index + i);
+    }
+  }
+  renderer->Geometry(texture, vertices_.data(), static_cast<int>(vertices_.size()), indices_.data(),
+                     static_cast<int>(indices_.size()));
+#else
+  (void)texture_width;
+  (void)texture_height;
+  for (const auto& quad : quads_) {
+    renderer->SetTextureColorMod(texture, quad.color_.r, quad.color_.g, quad.color_.b);
+    renderer->SetTextureAlphaMod(texture, quad.color_.a);
+    renderer->Copy(texture, &quad.src_, &quad.dst_);
+  }
+  renderer->SetTextureColorMod(texture, 255, 255, 255);
+  renderer->SetTextureAlphaMod(texture, 255);
+#endif
+  quads_.clear();
+}
+
+} // namespace utility
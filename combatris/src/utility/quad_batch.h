@@ -0,0 +1,37 @@
+#pragma once
+
+#include "utility/renderer.h"
+
+#include <vector>
+
+namespace utility {
+
+// Textured quads drawn with one SDL_RenderGeometry call, one SDL_RenderCopy per quad before SDL 2.0.18. The vertex
+// color tints the quad, a white area of the texture gives a filled rectangle.
+class QuadBatch final {
+ public:
+  QuadBatch() = default;
+
+  QuadBatch(const QuadBatch&) = delete;
+
+  inline void Add(const SDL_Rect& src, const SDL_Rect& dst, SDL_Color color) { quads_.push_back({ src, dst, color }); }
+
+  inline bool empty() const { return quads_.empty(); }
+
+  void Flush(Renderer* renderer, Texture* texture, int texture_width, int texture_height);
+
+ private:
+  struct Quad {
+    SDL_Rect src_;
+    SDL_Rect dst_;
+    SDL_Color color_;
+  };
+
+  std::vector<Quad> quads_;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  std::vector<SDL_Vertex> vertices_;
+  std::vector<int> indices_;
+#endif
+};
+
+} // namespace utility
@@ -0,0 +1,329 @@
+#include "utility/renderer.h"
+
+#include <future>
+#include <iostream>
+
+namespace utility {
+
+void TextureDeleter::operator()(Texture* texture) const {
+  if (nullptr == renderer_) {
+    delete texture;
+    return;
+  }
+  renderer_->DestroyTexture(texture);
+}
+
+Renderer::Renderer(SDL_Window* window, Uint32 flags) : window_(window), window_event_(SDL_RegisterEvents(1)) {
+  std::promise<void> started;
+  auto is_started = started.get_future();
+
+  render_thread_ = std::thread([this, flags, &started] {
+    renderer_ = SDL_CreateRenderer(window_, -1, flags);
+    is_open_ = nullptr != renderer_;
+    if (!is_open_) {
+      std::cout << "Failed to create renderer : " << SDL_GetError() << std::endl;
+    }
+    target_supported_ = is_open_ && SDL_RenderTargetSupported(renderer_);
+    started.set_value();
+    if (is_open_) {
+      Run();
+      SDL_DestroyRenderer(renderer_);
+    }
+  });
+  is_started.wait();
+}
+
+Renderer::~Renderer() noexcept {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  cancelled_ = true;
+  lock.unlock();
+  frame_handed_over_.notify_one();
+  render_thread_.join();
+  // The calls not drawn may be the last to refer to a texture handle
+  for (const auto& frame : frames_) {
+    for (const auto& call : frame.calls_) {
+      if (Op::DestroyTexture == call.op_) {
+        delete call.texture_;
+      }
+    }
+  }
+}
+
+bool Renderer::CanPresent() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+
+  return !frame_ready_;
+}
+
+void Renderer::Present() {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  // The calls recorded are kept and handed over with the next frame, only the present is left out
+  if (frame_ready_) {
+    return;
+  }
+  Record(Op::Present);
+  std::swap(recording_, ready_);
+  frame_ready_ = true;
+  lock.unlock();
+  frame_handed_over_.notify_one();
+}
+
+UniqueTexturePtr Renderer::CreateTexture(Uint32 format, int access, int width, int height) {
+  if (SDL_TEXTUREACCESS_TARGET == access && !target_supported_) {
+    return nullptr;
+  }
+  UniqueTexturePtr texture(new Texture(width, height), TextureDeleter{ this });
+
+  Record(Op::CreateTexture, texture.get()).args_ = { static_cast<int>(format), access, 0, 0 };
+
+  return texture;
+}
+
+UniqueTexturePtr Renderer::CreateTextureFromSurface(UniqueSurfacePtr surface) {
+  if (!surface) {
+    return nullptr;
+  }
+  UniqueTexturePtr texture(new Texture(surface->w, surface->h), TextureDeleter{ this });
+  auto& frame = frames_[recording_];
+
+  Record(Op::CreateTextureFromSurface, texture.get()).first_ = frame.surfaces_.size();
+  frame.surfaces_.push_back(std::move(surface));
+
+  return texture;
+}
+
+void Renderer::DestroyTexture(Texture* texture) {
+  if (target_ == texture) {
+    target_ = nullptr;
+  }
+  Record(Op::DestroyTexture, texture);
+}
+
+void Renderer::SetTextureBlendMode(Texture* texture, SDL_BlendMode mode) {
+  Record(Op::SetTextureBlendMode, texture).args_[0] = mode;
+}
+
+void Renderer::SetTextureAlphaMod(Texture* texture, Uint8 alpha) {
+  Record(Op::SetTextureAlphaMod, texture).args_[0] = alpha;
+}
+
+void Renderer::SetTextureColorMod(Texture* texture, Uint8 r, Uint8 g, Uint8 b) {
+  Record(Op::SetTextureColorMod, texture).args_ = { r, g, b, 0 };
+}
+
+void Renderer::SetTarget(Texture* texture) {
+  target_ = texture;
+  Record(Op::SetTarget, texture);
+}
+
+void Renderer::SetDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a) {
+  Record(Op::SetDrawColor).args_ = { r, g, b, a };
+}
+
+void Renderer::Clear() { Record(Op::Clear); }
+
+void Renderer::FillRect(const SDL_Rect* rc) {
+  auto& call = Record(Op::FillRect);
+
+  if (nullptr != rc) {
+    call.dst_ = *rc;
+    call.has_dst_ = true;
+  }
+}
+
+void Renderer::FillRects(const SDL_Rect* rcs, int count) {
+  auto& rects = frames_[recording_].rects_;
+  auto& call = Record(Op::FillRects);
+
+  call.first_ = rects.size();
+  call.count_ = static_cast<size_t>(count);
+  rects.insert(rects.end(), rcs, rcs + count);
+}
+
+void Renderer::SetClipRect(const SDL_Rect* rc) {
+  auto& call = Record(Op::SetClipRect);
+
+  if (nullptr != rc) {
+    call.dst_ = *rc;
+    call.has_dst_ = true;
+  }
+}
+
+void Renderer::Copy(Texture* texture, const SDL_Rect* src, const SDL_Rect* dst) {
+  auto& call = Record(Op::Copy, texture);
+
+  if (nullptr != src) {
+    call.src_ = *src;
+    call.has_src_ = true;
+  }
+  if (nullptr != dst) {
+    call.dst_ = *dst;
+    call.has_dst_ = true;
+  }
+}
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+void Renderer::Geometry(Texture* texture, const SDL_Vertex* vertices, int num_vertices, const int* indices,
+                        int num_indices) {
+  auto& frame = frames_[recording_];
+  auto& call = Record(Op::Geometry, texture);
+
+  call.first_ = frame.vertices_.size();
+  call.count_ = static_cast<size_t>(num_vertices);
+  call.args_ = { static_cast<int>(frame.indices_.size()), num_indices, 0, 0 };
+  frame.vertices_.insert(frame.vertices_.end(), vertices, vertices + num_vertices);
+  frame.indices_.insert(frame.indices_.end(), indices, indices + num_indices);
+}
+#endif
+
+void Renderer::SetLogicalSize(int width, int height) {
+  Record(Op::SetLogicalSize).args_ = { width, height, 0, 0 };
+}
+
+void Renderer::SetWindow(const std::string& title, int width, int height) {
+  std::unique_lock<std::mutex> lock(mutex_);
+
+  window_title_ = title;
+  window_width_ = width;
+  window_height_ = height;
+  lock.unlock();
+
+  SDL_Event event{};
+
+  event.type = window_event_;
+  SDL_PushEvent(&event);
+}
+
+void Renderer::UpdateWindow() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  const auto title = window_title_;
+  const auto width = window_width_;
+  const auto height = window_height_;
+
+  lock.unlock();
+  SDL_SetWindowSize(window_, width, height);
+  SDL_SetWindowTitle(window_, title.c_str());
+}
+
+void Renderer::Frame::Clear() {
+  calls_.clear();
+  rects_.clear();
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  vertices_.clear();
+  indices_.clear();
+#endif
+  surfaces_.clear();
+}
+
+Renderer::Call& Renderer::Record(Op op, Texture* texture) {
+  auto& call = frames_[recording_].calls_.emplace_back();
+
+  call.op_ = op;
+  call.texture_ = texture;
+
+  return call;
+}
+
+void Renderer::Run() {
+  for (;;) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    frame_handed_over_.wait(lock, [this] { return frame_ready_ || cancelled_; });
+    if (cancelled_) {
+      return;
+    }
+    std::swap(ready_, drawing_);
+    frame_ready_ = false;
+    lock.unlock();
+    Draw(frames_[drawing_]);
+  }
+}
+
+// Nothing is drawn into a render target that could not be created, and a failed texture is left out by SDL
+void Renderer::Draw(Frame& frame) {
+  bool drawing = true;
+
+  for (const auto& call : frame.calls_) {
+    auto texture = (nullptr == call.texture_) ? nullptr : call.texture_->texture_;
+    const auto src = call.has_src_ ? &call.src_ : nullptr;
+    const auto dst = call.has_dst_ ? &call.dst_ : nullptr;
+
+    switch (call.op_) {
+      case Op::CreateTexture:
+        call.texture_->texture_ = SDL_CreateTexture(renderer_, static_cast<Uint32>(call.args_[0]), call.args_[1],
+                                                    call.texture_->width_, call.texture_->height_);
+        break;
+      case Op::CreateTextureFromSurface:
+        call.texture_->texture_ = SDL_CreateTextureFromSurface(renderer_, frame.surfaces_[call.first_].get());
+        break;
+      case Op::DestroyTexture:
+        if (nullptr != texture) {
+          SDL_DestroyTexture(texture);
+        }
+        delete call.texture_;
+        break;
+      case Op::SetTextureBlendMode:
+        SDL_SetTextureBlendMode(texture, static_cast<SDL_BlendMode>(call.args_[0]));
+        break;
+      case Op::SetTextureAlphaMod:
+        SDL_SetTextureAlphaMod(texture, static_cast<Uint8>(call.args_[0]));
+        break;
+      case Op::SetTextureColorMod:
+        SDL_SetTextureColorMod(texture, static_cast<Uint8>(call.args_[0]), static_cast<Uint8>(call.args_[1]),
+                               static_cast<Uint8>(call.args_[2]));
+        break;
+      case Op::SetTarget:
+        drawing = nullptr == call.texture_ || nullptr != texture;
+        if (drawing) {
+          SDL_SetRenderTarget(renderer_, texture);
+        }
+        break;
+      case Op::SetDrawColor:
+        SDL_SetRenderDrawColor(renderer_, static_cast<Uint8>(call.args_[0]), static_cast<Uint8>(call.args_[1]),
+                               static_cast<Uint8>(call.args_[2]), static_cast<Uint8>(call.args_[3]));
+        break;
+      case Op::Clear:
+        if (drawing) {
+          SDL_RenderClear(renderer_);
+        }
+        break;
+      case Op::FillRect:
+        if (drawing) {
+          SDL_RenderFillRect(renderer_, dst);
+        }
+        break;
+      case Op::FillRects:
+        if (drawing) {
+          SDL_RenderFillRects(renderer_, &frame.rects_[call.first_], static_cast<int>(call.count_));
+        }
+        break;
+      case Op::SetClipRect:
+        SDL_RenderSetClipRect(renderer_, dst);
+        break;
+      case Op::Copy:
+        if (drawing) {
+          SDL_RenderCopy(renderer_, texture, src, dst);
+        }
+        break;
+      case Op::Geometry:
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+        if (drawing) {
+          SDL_RenderGeometry(renderer_, texture, &frame.vertices_[call.first_], static_cast<int>(call.count_),
+                             &frame.indices_[call.args_[0]], call.args_[1]);
+        }
+#endif
+        break;
+      case Op::SetLogicalSize:
+        SDL_RenderSetLogicalSize(renderer_, call.args_[0], call.args_[1]);
+        break;
+      case Op::Present:
+        SDL_RenderPresent(renderer_);
+        break;
+    }
+  }
+  frame.Clear();
+}
+
+} // namespace utility
@@ -0,0 +1,187 @@
+#pragma once
+
+#include "utility/function_caller.h"
+
+#include <SDL.h>
+
+#include <array>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace utility {
+
+class Renderer;
+
+// A texture is asked for on the game thread and created on the render thread, the game only holds the handle
+class Texture final {
+ public:
+  Texture(int width, int height) : width_(width), height_(height) {}
+
+  Texture(const Texture&) = delete;
+
+  inline int width() const { return width_; }
+
+  inline int height() const { return height_; }
+
+ private:
+  friend class Renderer;
+
+  int width_;
+  int height_;
+  SDL_Texture* texture_ = nullptr; // Only touched by the render thread
+};
+
+// The texture is destroyed on the render thread after the calls recorded before it
+struct TextureDeleter {
+  void operator()(Texture* texture) const;
+
+  Renderer* renderer_ = nullptr;
+};
+
+using UniqueTexturePtr = std::unique_ptr<Texture, TextureDeleter>;
+
+using UniqueSurfacePtr = std::unique_ptr<SDL_Surface, function_caller<void(SDL_Surface*), &SDL_FreeSurface>>;
+
+// The SDL renderer is created by, and only used on, a render thread. The game thread calls the functions below, which
+// are recorded into a frame instead of run, and Present hands the frame over. There are three frames, one recorded by
+// the game, one drawn by the render thread and the one handed over last waiting to be drawn, so neither thread waits
+// for the other. The window stays with the main thread, its size and title are handed over the same way.
+class Renderer final {
+ public:
+  Renderer(SDL_Window* window, Uint32 flags);
+
+  Renderer(const Renderer&) = delete;
+
+  ~Renderer() noexcept;
+
+  inline bool is_open() const { return is_open_; }
+
+  inline bool TargetSupported() const { return target_supported_; }
+
+  // False while the render thread has not picked up the frame handed over last, a frame drawn now would be dropped
+  bool CanPresent() const;
+
+  void Present();
+
+  // Returns nullptr for a render target if render targets are not supported
+  UniqueTexturePtr CreateTexture(Uint32 format, int access, int width, int height);
+
+  UniqueTexturePtr CreateTextureFromSurface(UniqueSurfacePtr surface);
+
+  void SetTextureBlendMode(Texture* texture, SDL_BlendMode mode);
+
+  void SetTextureAlphaMod(Texture* texture, Uint8 alpha);
+
+  void SetTextureColorMod(Texture* texture, Uint8 r, Uint8 g, Uint8 b);
+
+  void SetTarget(Texture* texture);
+
+  inline Texture* GetTarget() const { return target_; }
+
+  void SetDrawColor(Uint8 r, Uint8 g, Uint8 b, Uint8 a);
+
+  void Clear();
+
+  void FillRect(const SDL_Rect* rc);
+
+  void FillRects(const SDL_Rect* rcs, int count);
+
+  void SetClipRect(const SDL_Rect* rc);
+
+  void Copy(Texture* texture, const SDL_Rect* src, const SDL_Rect* dst);
+
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+  void Geometry(Texture* texture, const SDL_Vertex* vertices, int num_vertices, const int* indices, int num_indices);
+#endif
+
+  void SetLogicalSize(int width, int height);
+
+  // Pushes the window event, the main thread then calls UpdateWindow
+  void SetWindow(const std::string& title, int width, int height);
+
+  inline Uint32 window_event() const { return window_event_; }
+
+  void UpdateWindow();
+
+ private:
+  friend struct TextureDeleter;
+
+  enum class Op {
+    CreateTexture,
+    CreateTextureFromSurface,
+    DestroyTexture,
+    SetTextureBlendMode,
+    SetTextureAlphaMod,
+    SetTextureColorMod,
+    SetTarget,
+    SetDrawColor,
+    Clear,
+    FillRect,
+    FillRects,
+    SetClipRect,
+    Copy,
+    Geometry,
+    SetLogicalSize,
+    Present
+  };
+
+  // The arguments of a call, the rects of FillRects, the vertices and indices of Geometry and the surfaces are kept in
+  // the frame and referred to by first_ and count_
+  struct Call {
+    Op op_;
+    Texture* texture_ = nullptr;
+    std::array<int, 4> args_ = { 0, 0, 0, 0 };
+    SDL_Rect src_ = { 0, 0, 0, 0 };
+    SDL_Rect dst_ = { 0, 0, 0, 0 };
+    bool has_src_ = false;
+    bool has_dst_ = false;
+    size_t first_ = 0;
+    size_t count_ = 0;
+  };
+
+  // The calls are kept when a frame is cleared, so the vectors don't allocate once they have grown to the frame size
+  struct Frame {
+    void Clear();
+
+    std::vector<Call> calls_;
+    std::vector<SDL_Rect> rects_;
+#if SDL_VERSION_ATLEAST(2, 0, 18)
+    std::vector<SDL_Vertex> vertices_;
+    std::vector<int> indices_;
+#endif
+    std::vector<UniqueSurfacePtr> surfaces_;
+  };
+
+  Call& Record(Op op, Texture* texture = nullptr);
+
+  void DestroyTexture(Texture* texture);
+
+  void Run();
+
+  void Draw(Frame& frame);
+
+  SDL_Window* window_;
+  SDL_Renderer* renderer_ = nullptr;
+  bool is_open_ = false;
+  bool target_supported_ = false;
+  Uint32 window_event_;
+  Texture* target_ = nullptr; // As recorded
+  std::array<Frame, 3> frames_;
+  size_t recording_ = 0;
+  size_t ready_ = 1;
+  size_t drawing_ = 2;
+  bool frame_ready_ = false;
+  bool cancelled_ = false;
+  mutable std::mutex mutex_;
+  std::condition_variable frame_handed_over_;
+  std::string window_title_;
+  int window_width_ = 0;
+  int window_height_ = 0;
+  std::thread render_thread_;
+};
+
+} // namespace utility
@@ -2,50 +2,45 @@
 
 namespace utility {
 
-std::tuple<UniqueTexturePtr, int, int> CreateTextureFromText(SDL_Renderer* renderer, TTF_Font* font, const std::string& text,
+std::tuple<UniqueTexturePtr, int, int> CreateTextureFromText(Renderer* renderer, TTF_Font* font, const std::string& text,
                                                          Color text_color) {
-  SDL_Surface* surface = TTF_RenderText_Blended(font, text.c_str(), GetColor(text_color, 0));
-  auto texture = UniqueTexturePtr{ SDL_CreateTextureFromSurface(renderer, surface) };
+  UniqueSurfacePtr surface(TTF_RenderText_Blended(font, text.c_str(), GetColor(text_color, 0)));
 
   auto width = surface->w;
   auto height = surface->h;
-
-  SDL_FreeSurface(surface);
+  auto texture = renderer->CreateTextureFromSurface(std::move(surface));
 
   return std::make_tuple(std::move(texture), width, height);
 }
 
-void RenderText(SDL_Renderer *renderer, int x, int y, TTF_Font* font, const std::string& text, Color text_color) {
+void RenderText(Renderer *renderer, int x, int y, TTF_Font* font, const std::string& text, Color text_color) {
   auto [texture, width, height] = CreateTextureFromText(renderer, font, text, text_color);
 
   SDL_Rect rc{ x, y, width, height };
 
-  SDL_RenderCopy(renderer, texture.get(), nullptr, &rc);
+  renderer->Copy(texture.get(), nullptr, &rc);
 }
 
-std::tuple<UniqueTexturePtr, int, int> CreateTextureFromFramedText(SDL_Renderer* renderer, TTF_Font* font,
+std::tuple<UniqueTexturePtr, int, int> CreateTextureFromFramedText(Renderer* renderer, TTF_Font* font,
                                                                const std::string& text, Color text_color,
                                                                Color background_color) {
-  SDL_Surface* surface = TTF_RenderText_Shaded(font, text.c_str(), GetColor(text_color), GetColor(background_color));
-  auto source_texture = UniqueTexturePtr{ SDL_CreateTextureFromSurface(renderer, surface) };
+  UniqueSurfacePtr surface(TTF_RenderText_Shaded(font, text.c_str(), GetColor(text_color), GetColor(background_color)));
 
   auto width = surface->w + 2;
   auto height = surface->h + 2;
+  auto source_texture = renderer->CreateTextureFromSurface(std::move(surface));
+  auto target_texture = renderer->CreateTexture(SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height);
 
-  SDL_FreeSurface(surface);
-
-  auto target_texture = UniqueTexturePtr{ SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET, width, height) };
-
-  SDL_SetRenderTarget(renderer, target_texture.get());
-  SDL_RenderClear(renderer);
-  SDL_SetRenderDrawColor(renderer, 255, 255, 255, 0);
+  renderer->SetTarget(target_texture.get());
+  renderer->Clear();
+  renderer->SetDrawColor(255, 255, 255, 0);
 
   SDL_Rect rc{ 0, 0, width, height };
 
-  SDL_RenderFillRect(renderer, &rc);
+  renderer->FillRect(&rc);
   rc = { 1, 1, width - 2, height - 2 };
-  SDL_RenderCopy(renderer, source_texture.get(), nullptr, &rc);
-  SDL_SetRenderTarget(renderer, nullptr);
+  renderer->Copy(source_texture.get(), nullptr, &rc);
+  renderer->SetTarget(nullptr);
 
   return std::make_tuple(std::move(target_texture), width, height);
 }
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "utility/function_caller.h"
+#include "utility/renderer.h"
 #include "utility/color.h"
 
 #include <tuple>
@@ -11,14 +11,12 @@
 
 namespace utility {
 
-using UniqueTexturePtr = std::unique_ptr<SDL_Texture, function_caller<void(SDL_Texture*), &SDL_DestroyTexture>>;
+void RenderText(Renderer* renderer, int x, int y, TTF_Font* font, const std::string& text, Color text_color);
 
-void RenderText(SDL_Renderer* renderer, int x, int y, TTF_Font* font, const std::string& text, Color text_color);
-
-std::tuple<UniqueTexturePtr, int, int> CreateTextureFromText(SDL_Renderer* renderer, TTF_Font* font,
+std::tuple<UniqueTexturePtr, int, int> CreateTextureFromText(Renderer* renderer, TTF_Font* font,
                                                              const std::string& text, Color text_color);
 
-std::tuple<UniqueTexturePtr, int, int> CreateTextureFromFramedText(SDL_Renderer* renderer, TTF_Font* font,
+std::tuple<UniqueTexturePtr, int, int> CreateTextureFromFramedText(Renderer* renderer, TTF_Font* font,
                                                                    const std::string& text, Color text_color,
                                                                    Color background_color);
 inline int Center(int w1, int w2 ) { return std::abs(w1 - w2) / 2; }
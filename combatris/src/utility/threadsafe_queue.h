@@ -1,13 +1,18 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
-#include <queue>
+#include <chrono>
+#include <vector>
+#include <mutex>
 #include <condition_variable>
 
+// The values are kept in a ring buffer that only grows, so once it has reached the size needed pushing and popping
+// don't allocate
 template<typename T>
 class ThreadSafeQueue {
  public:
-  ThreadSafeQueue() : abort_(false), size_(0) {}
+  ThreadSafeQueue() : abort_(false), head_(0), size_(0) {}
 
   ThreadSafeQueue(const ThreadSafeQueue&) = delete;
 
@@ -16,8 +21,11 @@ class ThreadSafeQueue {
   void Push(T new_value) {
     std::unique_lock<std::mutex> lock(mutex_);
 
-    queue_.push(std::move(new_value));
-    size_ = queue_.size();
+    if (size_ == buffer_.size()) {
+      Grow();
+    }
+    buffer_[(head_ + size_) % buffer_.size()] = std::move(new_value);
+    ++size_;
     lock.unlock();
     event_.notify_one();
   }
@@ -31,17 +39,24 @@ class ThreadSafeQueue {
   T Pop() {
     std::unique_lock<std::mutex> lock(mutex_);
 
-    event_.wait(lock, [this] { return !queue_.empty() || abort_; });
+    event_.wait(lock, [this] { return size_ > 0 || abort_; });
 
     if (is_cancelled()) {
       return T();
     }
-    auto value(std::move(queue_.front()));
+    return Take();
+  }
 
-    queue_.pop();
-    size_ = queue_.size();
+  // Returns false if nothing was pushed within max_wait or the queue is cancelled
+  bool Pop(T& value, std::chrono::milliseconds max_wait) {
+    std::unique_lock<std::mutex> lock(mutex_);
 
-    return value;
+    if (!event_.wait_for(lock, max_wait, [this] { return size_ > 0 || abort_; }) || is_cancelled()) {
+      return false;
+    }
+    value = Take();
+
+    return true;
   }
 
   void Cancel() noexcept {
@@ -62,9 +77,31 @@ class ThreadSafeQueue {
   inline bool empty() const { return 0 == size_; }
 
  private:
+  static constexpr size_t kInitialCapacity = 64;
+
+  T Take() {
+    auto value(std::move(buffer_[head_]));
+
+    head_ = (head_ + 1) % buffer_.size();
+    --size_;
+
+    return value;
+  }
+
+  void Grow() {
+    std::vector<T> buffer(std::max(kInitialCapacity, buffer_.size() * 2));
+
+    for (size_t i = 0; i < size_; ++i) {
+      buffer[i] = std::move(buffer_[(head_ + i) % buffer_.size()]);
+    }
+    buffer_.swap(buffer);
+    head_ = 0;
+  }
+
   mutable std::mutex mutex_;
   std::condition_variable event_;
-  std::queue<T> queue_;
+  std::vector<T> buffer_;
   std::atomic<bool> abort_;
-  size_t size_;
+  size_t head_;
+  std::atomic<size_t> size_; // Read without the lock by size and empty
 };
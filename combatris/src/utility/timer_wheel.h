@@ -0,0 +1,111 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+namespace utility {
+
+// Hashed timer wheel, a slot holds the timers expiring within the ticks that map to the slot. Advancing the wheel only
+// touches the slots of the ticks that have passed. The deadlines are also kept ordered, so the earliest deadline is
+// at hand and scheduling, refreshing and cancelling a timer is O(log n).
+template<typename Key>
+class TimerWheel final {
+ public:
+  TimerWheel(int64_t resolution, size_t slots, int64_t now) : resolution_(resolution), slots_(slots), tick_(now / resolution) {}
+
+  TimerWheel(const TimerWheel&) = delete;
+
+  // Schedules the timer, or moves it if it's already scheduled
+  void Schedule(const Key& key, int64_t deadline) {
+    const auto slot = static_cast<size_t>(std::max(deadline / resolution_, tick_) % static_cast<int64_t>(slots_.size()));
+    auto it = timers_.find(key);
+
+    if (it != timers_.end()) {
+      // The nodes are reused, refreshing a timer doesn't allocate
+      auto node = deadlines_.extract(deadlines_.find(it->second.deadline_));
+
+      node.value() = deadline;
+      deadlines_.insert(std::move(node));
+      it->second.deadline_ = deadline;
+      if (it->second.slot_ == slot) {
+        return;
+      }
+      slots_.at(slot).insert(slots_.at(it->second.slot_).extract(key));
+      it->second.slot_ = slot;
+      return;
+    }
+    timers_.emplace(key, Timer{ deadline, slot });
+    slots_.at(slot).insert(key);
+    deadlines_.insert(deadline);
+  }
+
+  void Cancel(const Key& key) {
+    auto it = timers_.find(key);
+
+    if (it == timers_.end()) {
+      return;
+    }
+    slots_.at(it->second.slot_).erase(key);
+    deadlines_.erase(deadlines_.find(it->second.deadline_));
+    timers_.erase(it);
+  }
+
+  // Calls on_expired(key) for every timer with a deadline at or before now. The timers are removed before the calls,
+  // so they can be scheduled again from on_expired.
+  template<typename Function>
+  void Advance(int64_t now, Function on_expired) {
+    const auto now_tick = now / resolution_;
+    const auto ticks = std::min(now_tick - tick_ + 1, static_cast<int64_t>(slots_.size()));
+    std::vector<Key> expired;
+
+    for (int64_t i = 0; i < ticks; ++i) {
+      auto& slot = slots_.at(static_cast<size_t>((tick_ + i) % static_cast<int64_t>(slots_.size())));
+
+      for (auto it = slot.begin(); it != slot.end();) {
+        const auto deadline = timers_.at(*it).deadline_;
+
+        if (deadline <= now) {
+          deadlines_.erase(deadlines_.find(deadline));
+          expired.push_back(*it);
+          timers_.erase(*it);
+          it = slot.erase(it);
+        } else {
+          ++it;
+        }
+      }
+    }
+    tick_ = std::max(tick_, now_tick);
+    for (const auto& key : expired) {
+      on_expired(key);
+    }
+  }
+
+  // Returns the earliest deadline, or the max value if there are no timers
+  inline int64_t next_deadline() const {
+    return deadlines_.empty() ? std::numeric_limits<int64_t>::max() : *deadlines_.begin();
+  }
+
+  inline bool is_scheduled(const Key& key) const { return timers_.count(key) > 0; }
+
+  inline size_t size() const { return timers_.size(); }
+
+ private:
+  struct Timer {
+    int64_t deadline_;
+    size_t slot_;
+  };
+
+  int64_t resolution_;
+  std::vector<std::unordered_set<Key>> slots_;
+  std::unordered_map<Key, Timer> timers_;
+  std::multiset<int64_t> deadlines_;
+  int64_t tick_;
+};
+
+} // namespace utility
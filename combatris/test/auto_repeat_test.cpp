@@ -0,0 +1,45 @@
+#include "utility/auto_repeat.h"
+
+#include "catch.hpp"
+
+#include <vector>
+
+using namespace utility;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::vector<int64_t> Run(AutoRepeat& auto_repeat, AutoRepeat::Clock::time_point start, AutoRepeat::Clock::duration until) {
+  std::vector<int64_t> repeats;
+
+  auto_repeat.Run(start + until, [&repeats, start](AutoRepeat::Clock::time_point at) {
+    repeats.push_back(std::chrono::duration_cast<std::chrono::milliseconds>(at - start).count());
+  });
+  return repeats;
+}
+
+} // namespace
+
+TEST_CASE("AutoRepeat") {
+  AutoRepeat auto_repeat(190ms, 45ms);
+  const auto start = AutoRepeat::Clock::now();
+
+  REQUIRE(!auto_repeat.active());
+  REQUIRE(Run(auto_repeat, start, 1000ms).empty());
+
+  auto_repeat.Press(start);
+  REQUIRE(Run(auto_repeat, start, 0ms) == std::vector<int64_t>{ 0 });
+  REQUIRE(Run(auto_repeat, start, 189ms).empty());
+  REQUIRE(Run(auto_repeat, start, 190ms) == std::vector<int64_t>{ 190 });
+  // Repeats are at the times scheduled, several are generated if Run is called late
+  REQUIRE(Run(auto_repeat, start, 330ms) == std::vector<int64_t>{ 235, 280, 325 });
+  REQUIRE(!auto_repeat.IsDue(start + 369ms));
+  REQUIRE(auto_repeat.IsDue(start + 370ms));
+
+  auto_repeat.Release();
+  REQUIRE(Run(auto_repeat, start, 1000ms).empty());
+
+  // A new press starts with the initial delay again
+  auto_repeat.Press(start + 2000ms);
+  REQUIRE(Run(auto_repeat, start, 2300ms) == std::vector<int64_t>{ 2000, 2190, 2235, 2280 });
+}
@@ -165,3 +165,22 @@ TEST_CASE("ClearedLineWithGarbageBetween") {
   REQUIRE(TSpinType::None == tspin_type);
   REQUIRE_FALSE(perfect_clear);
 }
+
+TEST_CASE("MatrixDamage") {
+  auto matrix = SetupTestHarnessMatrixOnly(kSendLinesBefore);
+  const SDL_Rect matrix_rc = { kMatrixStartX, kMatrixStartY, kMatrixWidth, kMatrixHeight };
+
+  auto damage = matrix->TakeDamage();
+  REQUIRE((damage.x == matrix_rc.x && damage.y == matrix_rc.y && damage.w == matrix_rc.w && damage.h == matrix_rc.h));
+  damage = matrix->TakeDamage();
+  REQUIRE(SDL_RectEmpty(&damage));
+  matrix->InsertLines(1);
+  damage = matrix->TakeDamage();
+  REQUIRE(!SDL_RectEmpty(&damage));
+  REQUIRE(damage.x >= matrix_rc.x);
+  REQUIRE(damage.y >= matrix_rc.y);
+  REQUIRE(damage.x + damage.w <= matrix_rc.x + matrix_rc.w);
+  REQUIRE(damage.y + damage.h <= matrix_rc.y + matrix_rc.h);
+  damage = matrix->TakeDamage();
+  REQUIRE(SDL_RectEmpty(&damage));
+}
@@ -0,0 +1,55 @@
+#include "network/connection.h"
+
+#include "catch.hpp"
+
+using namespace network;
+
+namespace {
+
+const uint64_t kOurHostId = 4711;
+const uint64_t kOtherHostId = 4712;
+
+// The clock of the other player is 1000 ms ahead of ours
+const uint32_t kClockOffset = 1000;
+
+// Our datagram sent at t1 reaches the other player after one_way ms, who holds it for delay ms before the echo, which
+// reaches us after one_way ms again
+TimeStamps Echo(uint32_t t1, uint32_t one_way, uint32_t delay) {
+  TimeStamps time_stamps(t1 + one_way + delay + kClockOffset);
+
+  time_stamps.SetEcho(kOurHostId, t1, delay);
+
+  return time_stamps;
+}
+
+} // namespace
+
+TEST_CASE("ConnectionStats") {
+  Connection connection("other", PackageArray(0));
+
+  REQUIRE_FALSE(connection.UpdateTimeStamps(TimeStamps(100), kOurHostId, 100));
+
+  auto echo = Echo(100, 20, 500);
+
+  echo.SetEcho(kOtherHostId, 100, 500);
+  REQUIRE_FALSE(connection.UpdateTimeStamps(echo, kOurHostId, 640));
+  REQUIRE(connection.stats().samples_ == 0);
+
+  REQUIRE(connection.UpdateTimeStamps(Echo(100, 20, 500), kOurHostId, 640));
+  REQUIRE(connection.stats().rtt_ == Approx(40.0));
+  REQUIRE(connection.stats().jitter_ == Approx(20.0));
+  REQUIRE(connection.stats().clock_offset_ == Approx(kClockOffset));
+
+  for (uint32_t t1 = 1000; t1 < 10000; t1 += 1000) {
+    REQUIRE(connection.UpdateTimeStamps(Echo(t1, 20, 100), kOurHostId, t1 + 140));
+  }
+  REQUIRE(connection.stats().samples_ == 10);
+  REQUIRE(connection.stats().rtt_ == Approx(40.0));
+  REQUIRE(connection.stats().jitter_ < 2.0);
+  REQUIRE(connection.stats().clock_offset_ == Approx(kClockOffset));
+
+  // The 32 bit clocks wrap around
+  REQUIRE(connection.UpdateTimeStamps(Echo(0xFFFFFFF0, 20, 0), kOurHostId, 0xFFFFFFF0 + 40));
+  REQUIRE(connection.stats().rtt_ == Approx(40.0));
+  REQUIRE(connection.stats().clock_offset_ == Approx(kClockOffset));
+}
@@ -0,0 +1,67 @@
+#include "utility/frame_scheduler.h"
+
+#include "catch.hpp"
+
+using namespace utility;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Every reading of the clock takes a little time, and a sleep takes exactly the time asked for
+class FakeClock final {
+ public:
+  FrameScheduler::Clock::time_point Now() {
+    now_ += 10us;
+    return now_;
+  }
+
+  void Sleep(FrameScheduler::Clock::duration duration) { now_ += duration; }
+
+  void Advance(FrameScheduler::Clock::duration duration) { now_ += duration; }
+
+  FrameScheduler MakeScheduler(int fps, int idle_fps) {
+    return FrameScheduler(fps, idle_fps, [this] { return Now(); }, [this](auto duration) { Sleep(duration); });
+  }
+
+  inline FrameScheduler::Clock::time_point time() const { return now_; }
+
+ private:
+  FrameScheduler::Clock::time_point now_;
+};
+
+double MeasureWait(FakeClock& clock, FrameScheduler& scheduler, bool idle,
+                   const std::function<bool()>& interrupted = nullptr) {
+  const auto start = clock.time();
+  const bool frame = scheduler.Wait(idle, interrupted);
+
+  REQUIRE(frame == !interrupted);
+
+  return std::chrono::duration<double, std::milli>(clock.time() - start).count();
+}
+
+} // namespace
+
+TEST_CASE("FrameScheduler") {
+  FakeClock clock;
+  auto scheduler = clock.MakeScheduler(100, 20);
+
+  // The first frame is due 10 ms after the scheduler was created
+  REQUIRE(MeasureWait(clock, scheduler, false) == Approx(10.0).margin(0.1));
+  REQUIRE(MeasureWait(clock, scheduler, false) == Approx(10.0).margin(0.1));
+  REQUIRE(MeasureWait(clock, scheduler, true) == Approx(50.0).margin(0.1));
+
+  // An interrupted wait returns at once and the frame keeps its deadline
+  REQUIRE(MeasureWait(clock, scheduler, false, []() { return true; }) < 0.1);
+  clock.Advance(4ms);
+  REQUIRE(MeasureWait(clock, scheduler, false) == Approx(6.0).margin(0.1));
+
+  // A frame that is late by more than an interval starts the next interval from now
+  clock.Advance(35ms);
+  REQUIRE(MeasureWait(clock, scheduler, false) < 0.1);
+  REQUIRE(MeasureWait(clock, scheduler, false) == Approx(10.0).margin(0.1));
+
+  auto unlimited = clock.MakeScheduler(0, 0);
+
+  REQUIRE(MeasureWait(clock, unlimited, false) < 0.1);
+  REQUIRE(MeasureWait(clock, unlimited, true) < 0.1);
+}
@@ -0,0 +1,85 @@
+#include "game/opponent_simulation.h"
+#include "game/assets.h"
+
+#include "catch.hpp"
+
+using namespace network;
+
+namespace {
+
+const uint64_t kSeed = 0x0123456789ABCDEF;
+
+void Replay(Matrix& matrix, OpponentSimulation& simulation, uint32_t& operations) {
+  for (const auto& operation : matrix.TakeJournal()) {
+    InputEvent input;
+
+    switch (operation.type_) {
+      case Matrix::Operation::Type::Commit:
+        input = InputEvent::Lock(static_cast<int>(operation.tetromino_), static_cast<int>(operation.angle_), operation.pos_.row(),
+                                 operation.pos_.col(), static_cast<int>(operation.latest_move_), operations * 100);
+        break;
+      case Matrix::Operation::Type::InsertLines:
+        input = InputEvent::Garbage(operation.lines_, operations * 100);
+        break;
+      case Matrix::Operation::Type::RemoveLines:
+        input = InputEvent::KnockedOut(operations * 100);
+        break;
+    }
+    REQUIRE(simulation.Apply(InputEvent(input.value())));
+    operations++;
+  }
+}
+
+} // namespace
+
+TEST_CASE("InputEventPacking") {
+  auto lock = InputEvent(InputEvent::Lock(7, 3, 21, 13, 4, 0xFFFFFFFF).value());
+
+  REQUIRE(lock.type() == InputEvent::Type::Lock);
+  REQUIRE(lock.tetromino() == 7);
+  REQUIRE(lock.angle() == 3);
+  REQUIRE(lock.row() == 21);
+  REQUIRE(lock.col() == 13);
+  REQUIRE(lock.latest_move() == 4);
+  REQUIRE(lock.time() == 0xFFFFFFFF);
+
+  auto hash = InputEvent(InputEvent::BoardHash(1000, 0xDEADBEEF).value());
+
+  REQUIRE(hash.type() == InputEvent::Type::BoardHash);
+  REQUIRE(hash.operations() == 1000);
+  REQUIRE(hash.hash() == 0xDEADBEEF);
+}
+
+TEST_CASE("InputStreamReplay") {
+  auto assets = std::make_shared<Assets>(nullptr);
+  Matrix matrix(nullptr, assets->GetTetrominos());
+  OpponentSimulation simulation(assets->GetTetrominos(), kSeed);
+  uint32_t operations = 0;
+
+  matrix.SetSeed(kSeed);
+  matrix.EnableJournal(true);
+
+  matrix.Commit(Tetromino::Type::I, Tetromino::Angle::A0, Tetromino::Move::Down, Position(0, 2));
+  matrix.Commit(Tetromino::Type::O, Tetromino::Angle::A0, Tetromino::Move::Down, Position(0, 6));
+  matrix.InsertLines(3);
+  matrix.Commit(Tetromino::Type::T, Tetromino::Angle::A90, Tetromino::Move::Rotation, Position(0, 8));
+  matrix.InsertLines(5);
+  Replay(matrix, simulation, operations);
+
+  REQUIRE(operations == 5);
+  REQUIRE(simulation.matrix().Hash() == matrix.Hash());
+  REQUIRE(simulation.Apply(InputEvent::BoardHash(operations, matrix.Hash())));
+
+  matrix.RemoveLines();
+  matrix.Commit(Tetromino::Type::Z, Tetromino::Angle::A0, Tetromino::Move::Left, Position(0, 3));
+  Replay(matrix, simulation, operations);
+  REQUIRE(simulation.matrix().Hash() == matrix.Hash());
+
+  simulation.SetPiece(PieceState{ static_cast<uint8_t>(Tetromino::Type::L), 0, 5, 4 });
+  REQUIRE(simulation.matrix().piece().type_ == Tetromino::Type::L);
+  simulation.SetPiece(PieceState{ static_cast<uint8_t>(Tetromino::Type::L), 0, 30, 4 });
+  REQUIRE(simulation.matrix().piece().type_ == Tetromino::Type::Empty);
+
+  REQUIRE_FALSE(simulation.Apply(InputEvent::BoardHash(operations, matrix.Hash() + 1)));
+  REQUIRE_FALSE(simulation.is_synced());
+}
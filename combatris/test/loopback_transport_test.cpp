@@ -0,0 +1,171 @@
+#include "network/loopback_transport.h"
+#include "network/listener.h"
+#include "network/sliding_window.h"
+
+#include "catch.hpp"
+
+using namespace network;
+
+namespace {
+
+const uint32_t kSeed = 4711;
+const int kSendInterval = 10;
+
+void Drain(Listener& listener) {
+  while (listener.Poll(0) != SOCKET_TIMEOUT) {
+  }
+}
+
+} // namespace
+
+TEST_CASE("LoopbackTransport") {
+  FaultSettings faults;
+
+  faults.latency_ = 30;
+
+  auto network = std::make_shared<LoopbackNetwork>(kSeed, faults);
+  LoopbackTransmitter transmitter(network, "loopback");
+  LoopbackReceiver receiver(network);
+  char buffer[16];
+
+  for (char i = 0; i < 3; ++i) {
+    transmitter.Send(&i, sizeof(i));
+    network->Advance(1);
+  }
+  REQUIRE(network->datagrams_in_flight() == 3);
+  REQUIRE(receiver.Receive(buffer, sizeof(buffer), 0) == SOCKET_TIMEOUT);
+  REQUIRE(receiver.Receive(buffer, sizeof(buffer), 10) == SOCKET_TIMEOUT);
+  REQUIRE(network->now() == 13);
+  for (char i = 0; i < 3; ++i) {
+    REQUIRE(receiver.Receive(buffer, sizeof(buffer), 100) == 1);
+    REQUIRE(buffer[0] == i);
+    REQUIRE(network->now() == 30 + i);
+  }
+  REQUIRE(network->datagrams_in_flight() == 0);
+}
+
+TEST_CASE("SlidingWindowSoak") {
+  const int kPackages = 5000;
+  FaultSettings faults;
+
+  faults.loss_ = 0.3;
+  faults.duplication_ = 0.1;
+  faults.reordering_ = 0.1;
+  faults.latency_ = 20;
+  faults.jitter_ = 15;
+
+  auto network = std::make_shared<LoopbackNetwork>(kSeed, faults);
+  LoopbackTransmitter transmitter(network, "soak");
+  Listener listener(std::make_unique<LoopbackReceiver>(network), "listener", false);
+  SlidingWindow sliding_window;
+
+  auto send = [&](Request request, uint64_t value) {
+    auto package = CreatePackage(request, value);
+    auto reliable_package = sliding_window.Push(transmitter.host_name(), package);
+
+    transmitter.Send(&reliable_package, sizeof(reliable_package));
+    network->Advance(kSendInterval);
+    Drain(listener);
+  };
+
+  send(Request::Join, 0);
+  for (int i = 1; i <= kPackages; ++i) {
+    send(Request::SendLines, i);
+  }
+  for (int i = 0; i < kWindowSize; ++i) {
+    send(Request::HeartBeat, 0);
+  }
+  while (network->datagrams_in_flight() > 0) {
+    listener.Poll(kSendInterval);
+  }
+  REQUIRE(listener.packages_available());
+  REQUIRE(listener.NextPackage().request() == Request::Join);
+
+  int expected = 1;
+
+  while (listener.packages_available()) {
+    auto response = listener.NextPackage();
+
+    REQUIRE(response.request() == Request::SendLines);
+    REQUIRE(response.payload().value() == static_cast<uint64_t>(expected));
+    expected++;
+  }
+  REQUIRE(expected == kPackages + 1);
+}
+
+TEST_CASE("ListenerResponses") {
+  auto network = std::make_shared<LoopbackNetwork>(kSeed, FaultSettings());
+  LoopbackTransmitter transmitter(network, "a-host-name-longer-than-the-small-string-buffer");
+  Listener listener(std::make_unique<LoopbackReceiver>(network), "listener", false);
+  SlidingWindow sliding_window;
+
+  auto join = CreatePackage(Request::Join, GameState::Waiting);
+  auto reliable_package = sliding_window.Push(transmitter.host_name(), join);
+
+  transmitter.Send(&reliable_package, sizeof(reliable_package));
+
+  UnreliablePackage piece_package(transmitter.host_name(), CreatePackage(12, 3400, 5, PieceState{ 3, 1, 10, 4 }));
+
+  transmitter.Send(&piece_package, piece_package.size());
+
+  MatrixState matrix_state;
+
+  matrix_state.fill(7);
+  UnreliablePackage key_frame_package(transmitter.host_name(), CreatePackage(13, 3500, 6, matrix_state));
+
+  key_frame_package.package_.header_.SetSeqenceNr(1);
+  transmitter.Send(&key_frame_package, key_frame_package.size());
+  Drain(listener);
+
+  REQUIRE(listener.queue_size() == 3);
+
+  auto response = listener.NextPackage();
+
+  REQUIRE(response.request() == Request::Join);
+  REQUIRE(response.host_name() == transmitter.host_name().substr(0, kHostNameMax));
+  REQUIRE(response.host_id() == std::hash<std::string>{}(transmitter.host_name()));
+  REQUIRE(response.payload().state() == GameState::Waiting);
+
+  response = listener.NextPackage();
+
+  REQUIRE(response.request() == Request::ProgressUpdate);
+  REQUIRE(response.progress_payload().encoding() == MatrixEncoding::Piece);
+  REQUIRE(response.progress_payload().lines() == 12);
+  REQUIRE(response.progress_payload().piece().row_ == 10);
+
+  response = listener.NextPackage();
+
+  REQUIRE(response.request() == Request::ProgressUpdate);
+  REQUIRE(response.progress_payload().score() == 3500);
+  REQUIRE(response.progress_payload().matrix_state() == matrix_state);
+}
+
+TEST_CASE("ListenerDropsDuplicates") {
+  auto network = std::make_shared<LoopbackNetwork>(kSeed, FaultSettings());
+  LoopbackTransmitter transmitter(network, "multi-homed");
+  Listener listener(std::make_unique<LoopbackReceiver>(network), "listener", false);
+  SlidingWindow sliding_window;
+
+  // Every datagram is received twice, as on a host with two interfaces on the same network
+  auto send_twice = [&](const void* buff, size_t size) {
+    transmitter.Send(buff, size);
+    transmitter.Send(buff, size);
+  };
+  for (auto request : { Request::Join, Request::NewGame }) {
+    auto package = CreatePackage(request, GameState::Waiting);
+    auto reliable_package = sliding_window.Push(transmitter.host_name(), package);
+
+    send_twice(&reliable_package, sizeof(reliable_package));
+  }
+  UnreliablePackage piece_package(transmitter.host_name(), CreatePackage(1, 100, 1, PieceState{ 1, 0, 0, 4 }));
+
+  send_twice(&piece_package, piece_package.size());
+  Drain(listener);
+
+  REQUIRE(listener.datagrams_received() == 6);
+  REQUIRE(listener.duplicates_received() == 3);
+  REQUIRE(listener.queue_size() == 3);
+  REQUIRE(listener.NextPackage().request() == Request::Join);
+  REQUIRE(listener.NextPackage().request() == Request::NewGame);
+  REQUIRE(listener.NextPackage().request() == Request::ProgressUpdate);
+}
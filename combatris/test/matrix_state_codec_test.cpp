@@ -0,0 +1,115 @@
+#include "network/matrix_state_codec.h"
+
+#include "catch.hpp"
+
+#include <algorithm>
+
+using namespace network;
+
+namespace {
+
+MatrixState CreateMatrixState(uint8_t value) {
+  MatrixState state;
+
+  state.fill(value);
+
+  return state;
+}
+
+} // namespace
+
+TEST_CASE("XorRunLengthEncodeDecode") {
+  auto reference = CreateMatrixState(0);
+  auto state = reference;
+  uint8_t buffer[kMatrixStateSize];
+
+  REQUIRE(XorRunLengthEncode(state, reference, buffer, sizeof(buffer)) == 0);
+
+  state[0] = 0x11;
+  state[50] = 0x23;
+  state[51] = 0x45;
+  state[99] = 0x70;
+
+  auto size = XorRunLengthEncode(state, reference, buffer, sizeof(buffer));
+
+  REQUIRE(size == 10);
+
+  MatrixState decoded;
+
+  REQUIRE(XorRunLengthDecode(buffer, size, reference, decoded));
+  REQUIRE(decoded == state);
+
+  REQUIRE(XorRunLengthEncode(CreateMatrixState(0x77), reference, buffer, sizeof(buffer)) == -1);
+  REQUIRE_FALSE(XorRunLengthDecode(buffer, 1, reference, decoded));
+}
+
+TEST_CASE("MatrixStateKeyFrames") {
+  MatrixStateEncoder encoder;
+  MatrixStateDecoder decoder;
+  ProgressPayload payload;
+  MatrixState decoded;
+  auto state = CreateMatrixState(0);
+
+  encoder.Encode(state, payload);
+  REQUIRE(payload.encoding() == MatrixEncoding::KeyFrame);
+  REQUIRE(payload.size() == kMatrixStateSize);
+  REQUIRE(decoder.Decode(payload, decoded));
+  REQUIRE(decoded == state);
+
+  for (int i = 1; i < kKeyFrameInterval; ++i) {
+    state[i] = 0x12;
+    encoder.Encode(state, payload);
+    REQUIRE(payload.encoding() == MatrixEncoding::Delta);
+    REQUIRE(payload.size() < kMatrixStateSize);
+    REQUIRE(decoder.Decode(payload, decoded));
+    REQUIRE(decoded == state);
+  }
+  encoder.Encode(state, payload);
+  REQUIRE(payload.encoding() == MatrixEncoding::KeyFrame);
+}
+
+TEST_CASE("MatrixStateLostKeyFrame") {
+  MatrixStateEncoder encoder;
+  MatrixStateDecoder decoder;
+  ProgressPayload payload;
+  MatrixState decoded;
+  auto state = CreateMatrixState(0);
+
+  encoder.Encode(state, payload);
+  state[10] = 0x33;
+  encoder.Encode(state, payload);
+  REQUIRE(payload.encoding() == MatrixEncoding::Delta);
+  REQUIRE_FALSE(decoder.Decode(payload, decoded));
+
+  encoder.ForceKeyFrame();
+  encoder.Encode(state, payload);
+  REQUIRE(decoder.Decode(payload, decoded));
+  REQUIRE(decoded == state);
+
+  state[11] = 0x44;
+  encoder.Encode(state, payload);
+  REQUIRE(decoder.Decode(payload, decoded));
+  REQUIRE(decoded == state);
+}
+
+TEST_CASE("MatrixStateOversizedDelta") {
+  MatrixStateEncoder encoder;
+  MatrixStateDecoder decoder;
+  ProgressPayload payload;
+  MatrixState decoded;
+  auto state = CreateMatrixState(0);
+
+  encoder.Encode(state, payload);
+  REQUIRE(decoder.Decode(payload, decoded));
+
+  // A size past the end of the payload, as a hostile or broken peer could send it
+  std::fill(payload.data(), payload.data() + kMatrixStateSize, 0);
+  payload.SetMatrixData(MatrixEncoding::Delta, payload.key_frame(), 255);
+  REQUIRE_FALSE(decoder.Decode(payload, decoded));
+  payload.SetMatrixData(MatrixEncoding::Delta, payload.key_frame(), kMatrixStateSize + 1);
+  REQUIRE_FALSE(decoder.Decode(payload, decoded));
+
+  payload.SetMatrixData(MatrixEncoding::Delta, payload.key_frame(), kMatrixStateSize);
+  REQUIRE(decoder.Decode(payload, decoded));
+  REQUIRE(decoded == state);
+}
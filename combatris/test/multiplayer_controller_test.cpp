@@ -0,0 +1,96 @@
+#include "network/multiplayer_controller.h"
+#include "network/loopback_transport.h"
+
+#include <future>
+#include "catch.hpp"
+
+using namespace network;
+
+namespace {
+
+class NullListener final : public ListenerInterface {
+ public:
+  virtual bool GotJoin(const std::string&, uint64_t) override { return true; }
+
+  virtual void GotLeave(uint64_t) override {}
+
+  virtual void GotNewGame(uint64_t) override {}
+
+  virtual void GotStartGame() override {}
+
+  virtual void GotNewState(uint64_t, GameState) override {}
+
+  virtual void GotProgressUpdate(uint64_t, int, int, int, const MatrixState&) override {}
+
+  virtual void GotProgressUpdate(uint64_t, int, int, int, const PieceState&) override {}
+
+  virtual void GotSeed(uint64_t, uint64_t) override {}
+
+  virtual void GotInput(uint64_t, const InputEvent&) override {}
+
+  virtual void GotLines(uint64_t, int) override {}
+
+  virtual void GotPlayerKnockedOut(uint64_t) override {}
+};
+
+// Blocks the send thread in the first call to Send until it's opened
+class GatedTransmitter final : public Transmitter {
+ public:
+  GatedTransmitter(const std::shared_ptr<LoopbackNetwork>& network, std::shared_future<void> gate)
+      : transmitter_(network, "gated"), gate_(gate) {}
+
+  virtual ssize_t Send(const void* buff, size_t size) override {
+    gate_.wait();
+    return transmitter_.Send(buff, size);
+  }
+
+  virtual const std::string& host_name() const override { return transmitter_.host_name(); }
+
+ private:
+  LoopbackTransmitter transmitter_;
+  std::shared_future<void> gate_;
+};
+
+} // namespace
+
+TEST_CASE("ProgressUpdateCoalescing") {
+  auto network = std::make_shared<LoopbackNetwork>(0, FaultSettings());
+  LoopbackReceiver receiver(network);
+  NullListener listener;
+  std::promise<void> gate;
+  MatrixState state{};
+  {
+    MultiPlayerController controller(&listener, std::make_unique<GatedTransmitter>(network, gate.get_future().share()),
+                                     std::make_unique<LoopbackReceiver>(network));
+
+    controller.Join();
+    for (int score = 1; score <= 1000; ++score) {
+      controller.SendUpdate(0, score, 1, state);
+      controller.SendUpdate(0, score, 1, PieceState{ 1, 0, 0, 0 });
+    }
+    controller.SendUpdate(4);
+    gate.set_value();
+  }
+  char buffer[2500];
+  std::vector<Request> reliable;
+  std::vector<std::pair<MatrixEncoding, uint32_t>> progress;
+
+  while (receiver.Receive(buffer, sizeof(buffer), 0) > 0) {
+    const auto header = reinterpret_cast<const PackageHeader*>(buffer);
+
+    if (Channel::Reliable == header->channel()) {
+      const auto package = reinterpret_cast<const ReliablePackage*>(buffer);
+
+      reliable.push_back(package->package_.packages_[0].header_.request());
+    } else {
+      const auto& payload = reinterpret_cast<const UnreliablePackage*>(buffer)->package_.payload_;
+
+      progress.emplace_back(payload.encoding(), payload.score());
+    }
+  }
+  // The reliable packages are sent first, then only the latest update of each kind
+  REQUIRE(reliable == std::vector<Request>{ Request::Join, Request::SendLines, Request::Leave });
+  REQUIRE(progress.size() == 2);
+  REQUIRE(progress.at(0) == std::make_pair(MatrixEncoding::KeyFrame, 1000u));
+  REQUIRE(progress.at(1) == std::make_pair(MatrixEncoding::Piece, 1000u));
+}
@@ -38,8 +38,8 @@ void CheckResponse(Listener& listener, const std::string& expected_host_name, Re
   REQUIRE(WaitForPackage(listener));
   auto rsp = listener.NextPackage();
 
-  REQUIRE(std::hash<std::string>{}(expected_host_name) == rsp.host_id_);
-  REQUIRE(expected_request == rsp.request_);
+  REQUIRE(std::hash<std::string>{}(expected_host_name) == rsp.host_id());
+  REQUIRE(expected_request == rsp.request());
 }
 
 TEST_CASE("TestDuplicatePackageDetection") {
@@ -0,0 +1,40 @@
+#include "network/progress_scheduler.h"
+
+#include "catch.hpp"
+
+using namespace network;
+
+TEST_CASE("ProgressScheduler") {
+  ProgressScheduler scheduler;
+
+  // Nothing is sent unless something has changed
+  REQUIRE_FALSE(scheduler.IsDue(1.0));
+  scheduler.Changed(false);
+  REQUIRE(scheduler.IsDue(1.0));
+  scheduler.Sent(1.0);
+
+  scheduler.Changed(false);
+  REQUIRE_FALSE(scheduler.IsDue(1.06));
+  REQUIRE(scheduler.IsDue(1.1));
+
+  // A locked tetromino is sent after the minimum interval
+  scheduler.Changed(true);
+  REQUIRE_FALSE(scheduler.IsDue(1.04));
+  REQUIRE(scheduler.IsDue(1.05));
+  scheduler.Sent(1.05);
+
+  // Slow or lossy connections stretch the intervals
+  scheduler.SetConnectionQuality(20.0, 0.0);
+  REQUIRE(scheduler.scale() == Approx(1.0));
+  scheduler.SetConnectionQuality(100.0, 0.0);
+  REQUIRE(scheduler.scale() == Approx(2.0));
+  scheduler.SetConnectionQuality(20.0, 0.1);
+  REQUIRE(scheduler.scale() == Approx(2.0));
+  scheduler.SetConnectionQuality(400.0, 0.5);
+  REQUIRE(scheduler.scale() == Approx(ProgressScheduler::kMaxScale));
+
+  scheduler.SetConnectionQuality(100.0, 0.0);
+  scheduler.Changed(true);
+  REQUIRE_FALSE(scheduler.IsDue(1.14));
+  REQUIRE(scheduler.IsDue(1.16));
+}
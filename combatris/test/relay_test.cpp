@@ -0,0 +1,191 @@
+#include "server/relay.h"
+#include "network/loopback_transport.h"
+#include "network/matrix_state_codec.h"
+#include "network/sliding_window.h"
+
+#include "catch.hpp"
+
+#include <vector>
+
+using namespace network;
+
+namespace {
+
+const uint32_t kSeed = 4711;
+const int kPolls = 8;
+
+// The receiver id of the other end is carried in the port of the address
+class LoopbackRelayTransport final : public RelayTransport {
+ public:
+  explicit LoopbackRelayTransport(const std::shared_ptr<LoopbackNetwork>& network) : receiver_(network) {}
+
+  virtual ssize_t Receive(void* buff, size_t max_size, sockaddr_in& from_addr, int max_wait_ms) override {
+    int from = kLoopbackAnyReceiver;
+    const auto size = receiver_.Receive(buff, max_size, from, max_wait_ms);
+
+    from_addr = sockaddr_in{};
+    from_addr.sin_port = static_cast<uint16_t>(from);
+
+    return size;
+  }
+
+  virtual ssize_t Send(const void* buff, size_t size, const sockaddr_in& to_addr) override {
+    return receiver_.Send(buff, size, to_addr.sin_port);
+  }
+
+  inline int id() const { return receiver_.id(); }
+
+ private:
+  LoopbackReceiver receiver_;
+};
+
+class Client final {
+ public:
+  Client(const std::shared_ptr<LoopbackNetwork>& network, const std::string& name, int relay_id)
+      : name_(name), receiver_(network), transmitter_(network, name, receiver_.id(), relay_id) {}
+
+  void Send(Request request, GameState state) {
+    auto package = sliding_window_.Push(name_, CreatePackage(request, state));
+
+    transmitter_.Send(&package, sizeof(package));
+  }
+
+  void SendProgress(const MatrixState& state) {
+    ProgressPayload payload(0, 0, 1);
+
+    encoder_.Encode(state, payload);
+
+    UnreliablePackage package(name_, ProgressPackage{ Header(Request::ProgressUpdate, sequence_nr_++), payload });
+
+    transmitter_.Send(&package, package.size());
+  }
+
+  // The datagrams the relay has sent to the client
+  std::vector<std::vector<char>> Receive() {
+    std::vector<std::vector<char>> datagrams;
+    char buffer[2500];
+    ssize_t size;
+
+    while ((size = receiver_.Receive(buffer, sizeof(buffer), 0)) > 0) {
+      datagrams.emplace_back(buffer, buffer + size);
+    }
+
+    return datagrams;
+  }
+
+  inline uint64_t host_id() const { return std::hash<std::string>{}(name_); }
+
+ private:
+  std::string name_;
+  LoopbackReceiver receiver_;
+  LoopbackTransmitter transmitter_;
+  SlidingWindow sliding_window_;
+  MatrixStateEncoder encoder_;
+  uint32_t sequence_nr_ = 0;
+};
+
+void Pump(Relay& relay) {
+  for (int i = 0; i < kPolls; ++i) {
+    REQUIRE(relay.Poll(0));
+  }
+}
+
+// Progress updates are sent without the unused end of the payload, so a datagram can be shorter than T
+template<typename T>
+const T& View(const std::vector<char>& datagram) {
+  REQUIRE(datagram.size() >= sizeof(PackageHeader));
+  return *reinterpret_cast<const T*>(datagram.data());
+}
+
+} // namespace
+
+TEST_CASE("RelayLobbyAndFanOut") {
+  auto network = std::make_shared<LoopbackNetwork>(kSeed, FaultSettings());
+  auto transport = std::make_unique<LoopbackRelayTransport>(network);
+  const auto relay_id = transport->id();
+  Relay relay(std::move(transport), 2, 0);
+  Client a(network, "a", relay_id);
+  Client b(network, "b", relay_id);
+  Client c(network, "c", relay_id);
+
+  a.Send(Request::Join, GameState::Idle);
+  Pump(relay);
+  b.Send(Request::Join, GameState::Idle);
+  Pump(relay);
+  // Both joins are fanned out to a, only the join of b to b
+  REQUIRE(a.Receive().size() == 2);
+  REQUIRE(b.Receive().size() == 1);
+
+  // The room is full, c is told so in its own name and nothing of c reaches the others
+  c.Send(Request::Join, GameState::Idle);
+  Pump(relay);
+
+  const auto refused = c.Receive();
+
+  REQUIRE(refused.size() == 1);
+
+  const auto& leave = View<ReliablePackage>(refused.front());
+
+  REQUIRE(static_cast<uint64_t>(leave.header_.host_id()) == c.host_id());
+  REQUIRE(leave.size() == 1);
+  REQUIRE(leave.package_.packages_[0].header_.request() == Request::Leave);
+  REQUIRE(a.Receive().empty());
+  REQUIRE(b.Receive().empty());
+
+  // Reliable packages are forwarded to every player in the room as they arrive
+  a.Send(Request::NewGame, GameState::Waiting);
+  Pump(relay);
+
+  const auto forwarded = b.Receive();
+
+  REQUIRE(forwarded.size() == 1);
+  REQUIRE(static_cast<uint64_t>(View<ReliablePackage>(forwarded.front()).header_.host_id()) == a.host_id());
+  REQUIRE(View<ReliablePackage>(forwarded.front()).package_.packages_[0].header_.request() == Request::NewGame);
+  REQUIRE(a.Receive().size() == 1);
+  REQUIRE(c.Receive().empty());
+}
+
+TEST_CASE("RelayKeyFrameBeforeDelta") {
+  const int kProgressInterval = 60 * 60 * 1000;
+  auto network = std::make_shared<LoopbackNetwork>(kSeed, FaultSettings());
+  auto transport = std::make_unique<LoopbackRelayTransport>(network);
+  const auto relay_id = transport->id();
+  Relay relay(std::move(transport), 2, kProgressInterval);
+  Client a(network, "a", relay_id);
+  Client b(network, "b", relay_id);
+  MatrixState state;
+
+  state.fill(0);
+  a.Send(Request::Join, GameState::Playing);
+  Pump(relay);
+  // Coalesced into the latest update, a delta based on the key frame sent before it
+  a.SendProgress(state);
+  Pump(relay);
+  state[10] = 0x33;
+  a.SendProgress(state);
+  Pump(relay);
+  a.Receive();
+
+  // b has not got the key frame the latest delta is based on, so it's sent before the delta
+  b.Send(Request::Join, GameState::Idle);
+  Pump(relay);
+
+  const auto datagrams = b.Receive();
+
+  REQUIRE(datagrams.size() == 3);
+  REQUIRE(View<PackageHeader>(datagrams[0]).channel() == Channel::Reliable);
+
+  const auto& key_frame = View<UnreliablePackage>(datagrams[1]).package_.payload_;
+  const auto& delta = View<UnreliablePackage>(datagrams[2]).package_.payload_;
+
+  REQUIRE(key_frame.encoding() == MatrixEncoding::KeyFrame);
+  REQUIRE(delta.encoding() == MatrixEncoding::Delta);
+  REQUIRE(delta.key_frame() == key_frame.key_frame());
+
+  MatrixStateDecoder decoder;
+  MatrixState decoded;
+
+  REQUIRE(decoder.Decode(key_frame, decoded));
+  REQUIRE(decoder.Decode(delta, decoded));
+  REQUIRE(decoded == state);
+}
@@ -0,0 +1,80 @@
+#include "network/session_capture.h"
+#include "network/listener.h"
+#include "network/sliding_window.h"
+
+#include "catch.hpp"
+
+#include <cstdio>
+
+using namespace network;
+
+namespace {
+
+const std::string kCaptureFile = "session_capture_test.cap";
+
+} // namespace
+
+TEST_CASE("SessionCaptureReplay") {
+  const int kPackages = 20;
+  const std::string host_name = "captured";
+
+  std::remove(kCaptureFile.c_str());
+  {
+    SlidingWindow sliding_window;
+    SessionCapture capture(kCaptureFile);
+
+    REQUIRE(capture.is_open());
+    for (int i = 0; i < kPackages; ++i) {
+      auto package = CreatePackage((i == 0) ? Request::Join : Request::SendLines, i);
+      auto reliable_package = sliding_window.Push(host_name, package);
+
+      capture.Write(&reliable_package, sizeof(reliable_package));
+    }
+  }
+  {
+    // Leaves a record cut short at the end of the file
+    CaptureRecord record{ 0, 100 };
+    auto file = std::fopen(kCaptureFile.c_str(), "ab");
+
+    std::fwrite(&record, sizeof(record), 1, file);
+    std::fclose(file);
+  }
+  SessionCaptureReader reader(kCaptureFile);
+  CaptureRecord record;
+  const char* data = nullptr;
+  int64_t time = 0;
+  int records = 0;
+
+  REQUIRE(reader.is_open());
+  while (reader.Next(record, data)) {
+    REQUIRE(record.size_ == sizeof(ReliablePackage));
+    REQUIRE(record.time_ >= time);
+    time = record.time_;
+    records++;
+  }
+  REQUIRE(records == kPackages);
+
+  Listener listener(std::make_unique<CaptureReceiver>(kCaptureFile, false), "listener", false);
+
+  while (listener.Poll(0) != SOCKET_TIMEOUT) {
+  }
+  REQUIRE(listener.datagrams_received() == kPackages);
+  REQUIRE(listener.NextPackage().request() == Request::Join);
+  for (int i = 1; i < kPackages; ++i) {
+    auto response = listener.NextPackage();
+
+    REQUIRE(response.host_name() == host_name);
+    REQUIRE(response.payload().value() == static_cast<uint64_t>(i));
+  }
+  REQUIRE_FALSE(listener.packages_available());
+  std::remove(kCaptureFile.c_str());
+}
+
+TEST_CASE("SessionCaptureFile") {
+  const auto first = GetSessionCaptureFile(kCaptureFile);
+  const auto second = GetSessionCaptureFile(kCaptureFile);
+
+  REQUIRE(first.find(kCaptureFile + ".") == 0);
+  REQUIRE(second.find(kCaptureFile + ".") == 0);
+  REQUIRE(first != second);
+}
@@ -0,0 +1,29 @@
+#include "utility/threadsafe_queue.h"
+
+#include "catch.hpp"
+
+TEST_CASE("ThreadSafeQueueWrapAround") {
+  ThreadSafeQueue<int> queue;
+  int pushed = 0;
+  int popped = 0;
+
+  for (int round = 0; round < 10; ++round) {
+    for (int i = 0; i < 50; ++i) {
+      queue.Push(pushed++);
+    }
+    for (int i = 0; i < 30; ++i) {
+      REQUIRE(queue.Pop() == popped++);
+    }
+  }
+  REQUIRE(queue.size() == static_cast<size_t>(pushed - popped));
+  while (!queue.empty()) {
+    REQUIRE(queue.Pop() == popped++);
+  }
+  REQUIRE(popped == pushed);
+
+  int value = 0;
+
+  REQUIRE_FALSE(queue.Pop(value, std::chrono::milliseconds(1)));
+  queue.Cancel();
+  REQUIRE_FALSE(queue.Pop(value));
+}
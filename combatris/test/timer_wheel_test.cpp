@@ -0,0 +1,54 @@
+#include "utility/timer_wheel.h"
+
+#include "catch.hpp"
+
+using namespace utility;
+
+namespace {
+
+std::vector<int> Advance(TimerWheel<int>& timers, int64_t now) {
+  std::vector<int> expired;
+
+  timers.Advance(now, [&expired](int key) { expired.push_back(key); });
+  std::sort(expired.begin(), expired.end());
+
+  return expired;
+}
+
+} // namespace
+
+TEST_CASE("TimerWheel") {
+  TimerWheel<int> timers(10, 8, 1000);
+
+  timers.Schedule(1, 1005);
+  timers.Schedule(2, 1050);
+  timers.Schedule(3, 1200);  // More than one revolution ahead
+  timers.Schedule(4, 990);   // Already expired
+  REQUIRE(timers.size() == 4);
+  REQUIRE(timers.next_deadline() == 990);
+
+  REQUIRE(Advance(timers, 1004) == std::vector<int>{ 4 });
+  REQUIRE(Advance(timers, 1005) == std::vector<int>{ 1 });
+
+  // Refreshing moves the deadline, cancelling removes the timer
+  timers.Schedule(2, 1100);
+  REQUIRE(timers.next_deadline() == 1100);
+  REQUIRE(Advance(timers, 1060).empty());
+  timers.Schedule(5, 1070);
+  REQUIRE(timers.next_deadline() == 1070);
+  timers.Cancel(5);
+  REQUIRE_FALSE(timers.is_scheduled(5));
+  REQUIRE(timers.next_deadline() == 1100);
+
+  REQUIRE(Advance(timers, 1130) == std::vector<int>{ 2 });
+  REQUIRE(Advance(timers, 1199).empty());
+  REQUIRE(Advance(timers, 5000) == std::vector<int>{ 3 });
+  REQUIRE(timers.size() == 0);
+  REQUIRE(timers.next_deadline() == std::numeric_limits<int64_t>::max());
+
+  // Timers can be scheduled again when they expire
+  timers.Schedule(6, 5010);
+  timers.Advance(5010, [&timers](int key) { timers.Schedule(key, 5020); });
+  REQUIRE(timers.next_deadline() == 5020);
+  REQUIRE(Advance(timers, 5020) == std::vector<int>{ 6 });
+}
@@ -1,5 +1,10 @@
 #include "network/protocol.h"
 #include "network/udp_client_server.h"
+#include "network/network_interfaces.h"
+
+#if defined(_WIN64)
+#include <ws2tcpip.h>
+#endif
 
 #include <thread>
 #include <future>
@@ -114,3 +119,37 @@ TEST_CASE("RunClient", "[!hide]") {
 
   client.Send(&package, sizeof(package));
 }
+
+TEST_CASE("ClientServerErrors") {
+  UDPClient client("", GetPort());
+
+  REQUIRE_FALSE(client.is_open());
+  REQUIRE_FALSE(client.error().empty());
+
+  UDPServer server(80);
+
+  REQUIRE_FALSE(server.is_open());
+  REQUIRE_FALSE(server.error().empty());
+}
+
+TEST_CASE("NetworkInterfaces") {
+  const auto& interfaces = GetNetworkInterfaces();
+
+  REQUIRE(&interfaces == &GetNetworkInterfaces());
+  for (const auto& network_interface : interfaces) {
+    in_addr address{};
+    in_addr broadcast_address{};
+
+    REQUIRE(inet_pton(AF_INET, network_interface.address_.c_str(), &address) == 1);
+    REQUIRE(inet_pton(AF_INET, network_interface.broadcast_address_.c_str(), &broadcast_address) == 1);
+
+    const auto ip = ntohl(address.s_addr);
+    const auto broadcast_ip = ntohl(broadcast_address.s_addr);
+
+    REQUIRE((ip & network_interface.netmask_) == (broadcast_ip & network_interface.netmask_));
+    REQUIRE((broadcast_ip | network_interface.netmask_) == 0xFFFFFFFF);
+  }
+  if (!interfaces.empty() && nullptr == getenv("COMBATRIS_BROADCAST_IP")) {
+    REQUIRE(GetBroadcastAddress() == interfaces.front().broadcast_address_);
+  }
+}
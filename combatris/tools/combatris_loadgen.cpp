@@ -0,0 +1,249 @@
+#include "network/listener.h"
+#include "network/matrix_state_codec.h"
+#include "network/sliding_window.h"
+
+#include <algorithm>
+#include <csignal>
+#include <iomanip>
+#include <iterator>
+#include <random>
+#include <vector>
+
+// Spawns synthetic clients on localhost that speak the real protocol against a Listener in the same process, and
+// measures how much the Listener and a frame paced dispatch loop can take
+
+using namespace network;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const std::string kLocalhost = "127.0.0.1";
+const int kFrameInterval = 16;
+const int kDrainTime = 500;
+
+struct Settings {
+  int clients_ = 8;
+  int duration_ = 10;
+  int progress_rate_ = 10;
+  int burst_interval_ = 1000;
+  int burst_size_ = 4;
+};
+
+struct Counters {
+  std::atomic<uint64_t> reliable_sent_{0};
+  std::atomic<uint64_t> unreliable_sent_{0};
+  std::atomic<uint64_t> lines_sent_{0};
+};
+
+std::atomic<bool> cancelled(false);
+
+void SignalHandler(int) { cancelled.store(true, std::memory_order_release); }
+
+// Time stamps are carried in the payload as us since start, truncated to 32 bits for the score field
+uint64_t Elapsed(Clock::time_point start) {
+  return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count();
+}
+
+class SyntheticClient final {
+ public:
+  SyntheticClient(int index, const Settings& settings, Clock::time_point start, Counters& counters)
+      : host_name_("loadgen-" + std::to_string(index)), settings_(settings), start_(start), counters_(counters),
+        client_(kLocalhost, GetPort()), generator_(index) {
+    matrix_state_.fill(0);
+  }
+
+  void Run(Clock::time_point stop) {
+    const auto progress_interval = std::chrono::microseconds(1000000 / std::max(1, settings_.progress_rate_));
+    const auto heartbeat_interval = std::chrono::milliseconds(kHeartBeatInterval);
+    const auto burst_interval = std::chrono::milliseconds(settings_.burst_interval_);
+    auto next_progress = Clock::now();
+    auto next_heartbeat = next_progress + heartbeat_interval;
+    auto next_burst = next_progress + burst_interval;
+
+    Send(CreatePackage(Request::Join, GameState::Playing));
+    while (!cancelled.load(std::memory_order_acquire) && Clock::now() < stop) {
+      const auto now = Clock::now();
+
+      if (now >= next_progress) {
+        SendProgressUpdate();
+        next_progress += progress_interval;
+      }
+      if (now >= next_heartbeat) {
+        Send(CreatePackage(Request::HeartBeat));
+        next_heartbeat += heartbeat_interval;
+      }
+      if (settings_.burst_size_ > 0 && now >= next_burst) {
+        for (int i = 0; i < settings_.burst_size_; ++i) {
+          Send(CreatePackage(Request::SendLines, Elapsed(start_)));
+          counters_.lines_sent_++;
+        }
+        next_burst += burst_interval;
+      }
+      std::this_thread::sleep_until(std::min({ next_progress, next_heartbeat, next_burst, stop }));
+    }
+    Send(CreatePackage(Request::Leave, GameState::Idle));
+  }
+
+ private:
+  void Send(const Package& package) {
+    auto reliable_package = sliding_window_.Push(host_name_, package);
+
+    client_.Send(&reliable_package, sizeof(reliable_package));
+    counters_.reliable_sent_++;
+  }
+
+  void SendProgressUpdate() {
+    std::uniform_int_distribution<int> cell(0, kMatrixStateSize - 1);
+
+    for (int i = 0; i < 4; ++i) {
+      matrix_state_.at(cell(generator_)) = static_cast<uint8_t>(generator_() & 0xFF);
+    }
+    auto package = CreatePackage(0, static_cast<uint32_t>(Elapsed(start_)), 1, matrix_state_);
+
+    package.header_.SetSeqenceNr(sequence_nr_unreliable_++);
+    matrix_state_encoder_.Encode(package.payload_.matrix_state(), package.payload_);
+
+    UnreliablePackage unreliable_package(host_name_, package);
+
+    client_.Send(&unreliable_package, unreliable_package.size());
+    counters_.unreliable_sent_++;
+  }
+
+  std::string host_name_;
+  const Settings& settings_;
+  Clock::time_point start_;
+  Counters& counters_;
+  UDPClient client_;
+  std::mt19937 generator_;
+  SlidingWindow sliding_window_;
+  uint32_t sequence_nr_unreliable_ = 0;
+  MatrixState matrix_state_;
+  MatrixStateEncoder matrix_state_encoder_;
+};
+
+class Histogram final {
+ public:
+  void Add(double value) { values_.push_back(value); }
+
+  void Print(const std::string& name) {
+    std::cout << std::left << std::setw(24) << name;
+    if (values_.empty()) {
+      std::cout << "-" << std::endl;
+      return;
+    }
+    std::sort(values_.begin(), values_.end());
+    std::cout << std::fixed << std::setprecision(2) << "p50 " << Percentile(0.50) << " ms, p90 " << Percentile(0.90)
+              << " ms, p99 " << Percentile(0.99) << " ms, max " << values_.back() << " ms (" << values_.size() << ")"
+              << std::endl;
+  }
+
+ private:
+  double Percentile(double p) const { return values_.at(static_cast<size_t>(p * (values_.size() - 1))); }
+
+  std::vector<double> values_;
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  Settings settings;
+
+  try {
+    int* values[] = { &settings.clients_, &settings.duration_, &settings.progress_rate_, &settings.burst_interval_,
+                      &settings.burst_size_ };
+
+    for (int i = 1; i < argc && i <= static_cast<int>(std::size(values)); ++i) {
+      *values[i - 1] = std::stoi(argv[i]);
+    }
+  } catch (const std::exception&) {
+    std::cout << "Usage: " << argv[0] << " [clients (8)] [duration in s (10)] [progress updates per s (10)]"
+              << " [lines burst interval in ms (1000)] [lines per burst (4)]" << std::endl;
+    return -1;
+  }
+  std::signal(SIGINT, SignalHandler);
+  std::signal(SIGTERM, SignalHandler);
+
+  if (!Startup()) {
+    return -1;
+  }
+  Listener listener;
+  Counters counters;
+  const auto start = Clock::now();
+  const auto stop = start + std::chrono::seconds(settings.duration_);
+  std::vector<std::unique_ptr<SyntheticClient>> clients;
+  std::vector<std::thread> threads;
+
+  for (int i = 0; i < settings.clients_; ++i) {
+    clients.push_back(std::make_unique<SyntheticClient>(i, settings, start, counters));
+  }
+  for (auto& client : clients) {
+    threads.emplace_back(&SyntheticClient::Run, client.get(), stop);
+  }
+  std::cout << settings.clients_ << " clients, " << settings.progress_rate_ << " progress updates/s, "
+            << settings.burst_size_ << " lines every " << settings.burst_interval_ << " ms, port " << GetPort() << std::endl;
+
+  Histogram reliable_latency;
+  Histogram unreliable_latency;
+  Histogram dispatch_time;
+  size_t max_queue_size = 0;
+  uint64_t lines_received = 0;
+  uint64_t progress_received = 0;
+  uint64_t datagrams_last_second = 0;
+  auto next_report = start + std::chrono::seconds(1);
+  const auto drain_stop = stop + std::chrono::milliseconds(kDrainTime);
+
+  while (Clock::now() < drain_stop && !cancelled.load(std::memory_order_acquire)) {
+    const auto frame_start = Clock::now();
+
+    max_queue_size = std::max(max_queue_size, listener.queue_size());
+    while (listener.packages_available()) {
+      const auto response = listener.NextPackage();
+      const auto now = Elapsed(start);
+
+      switch (response.request()) {
+        case Request::SendLines:
+          reliable_latency.Add((now - response.payload().value()) / 1000.0);
+          lines_received++;
+          break;
+        case Request::ProgressUpdate:
+          unreliable_latency.Add(static_cast<uint32_t>(now - response.progress_payload().score()) / 1000.0);
+          progress_received++;
+          break;
+        default:
+          break;
+      }
+    }
+    dispatch_time.Add(std::chrono::duration<double, std::milli>(Clock::now() - frame_start).count());
+    if (Clock::now() >= next_report) {
+      const auto datagrams = listener.datagrams_received();
+
+      std::cout << "received " << (datagrams - datagrams_last_second) << " datagrams/s, queue depth "
+                << listener.queue_size() << ", max " << max_queue_size << std::endl;
+      datagrams_last_second = datagrams;
+      next_report += std::chrono::seconds(1);
+    }
+    std::this_thread::sleep_until(frame_start + std::chrono::milliseconds(kFrameInterval));
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  const auto seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  const auto sent = counters.reliable_sent_ + counters.unreliable_sent_;
+
+  std::cout << "-----\n"
+            << "datagrams sent          " << sent << " (" << static_cast<uint64_t>(sent / seconds) << "/s)\n"
+            << "datagrams received      " << listener.datagrams_received() << " ("
+            << static_cast<uint64_t>(listener.datagrams_received() / seconds) << "/s)\n"
+            << "datagrams dropped       " << (sent - std::min<uint64_t>(sent, listener.datagrams_received())) << "\n"
+            << "lines received          " << lines_received << " of " << counters.lines_sent_ << "\n"
+            << "progress received       " << progress_received << " of " << counters.unreliable_sent_ << "\n"
+            << "max queue depth         " << max_queue_size << std::endl;
+  reliable_latency.Print("SendLines latency");
+  unreliable_latency.Print("ProgressUpdate latency");
+  dispatch_time.Print("Dispatch per frame");
+
+  listener.Cancel();
+  Cleanup();
+
+  return 0;
+}
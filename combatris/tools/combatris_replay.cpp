@@ -0,0 +1,146 @@
+#include "network/loopback_transport.h"
+#include "network/multiplayer_controller.h"
+#include "network/session_capture.h"
+
+#include <csignal>
+#include <iomanip>
+#include <map>
+
+// Replays a capture taken with COMBATRIS_CAPTURE=<file> through a Listener and MultiPlayerController::Dispatch. At the
+// original speed the session is reproduced and every dispatched event is printed, at max speed the datagrams are
+// received as fast as the listener asks for them, which measures the receive and dispatch path.
+
+using namespace network;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+const int kFrameInterval = 16;
+
+std::atomic<bool> cancelled(false);
+
+void SignalHandler(int) { cancelled.store(true, std::memory_order_release); }
+
+class Recorder final : public ListenerInterface {
+ public:
+  explicit Recorder(bool verbose) : verbose_(verbose) {}
+
+  virtual bool GotJoin(const std::string& display_name, uint64_t host_id) override {
+    Count(Request::Join, host_id) << " " << display_name << std::endl;
+    return true;
+  }
+
+  virtual void GotLeave(uint64_t host_id) override { Count(Request::Leave, host_id) << std::endl; }
+
+  virtual void GotNewGame(uint64_t host_id) override { Count(Request::NewGame, host_id) << std::endl; }
+
+  virtual void GotStartGame() override { Count(Request::StartGame, 0) << std::endl; }
+
+  virtual void GotNewState(uint64_t host_id, GameState state) override {
+    Count(Request::NewState, host_id) << " " << static_cast<int>(state) << std::endl;
+  }
+
+  virtual void GotProgressUpdate(uint64_t host_id, int lines, int score, int level, const MatrixState&) override {
+    Count(Request::ProgressUpdate, host_id) << " lines " << lines << ", score " << score << ", level " << level << std::endl;
+  }
+
+  virtual void GotProgressUpdate(uint64_t host_id, int lines, int score, int level, const PieceState&) override {
+    Count(Request::ProgressUpdate, host_id) << " lines " << lines << ", score " << score << ", level " << level << std::endl;
+  }
+
+  virtual void GotSeed(uint64_t host_id, uint64_t seed) override { Count(Request::Seed, host_id) << " " << seed << std::endl; }
+
+  virtual void GotInput(uint64_t host_id, const InputEvent& input) override {
+    Count(Request::Input, host_id) << " " << static_cast<int>(input.type()) << std::endl;
+  }
+
+  virtual void GotLines(uint64_t host_id, int lines) override { Count(Request::SendLines, host_id) << " " << lines << std::endl; }
+
+  virtual void GotPlayerKnockedOut(uint64_t host_id) override { Count(Request::KnockedOutBy, host_id) << std::endl; }
+
+  uint64_t total() const {
+    uint64_t total = 0;
+
+    for (const auto& [request, count] : counts_) {
+      total += count;
+    }
+    return total;
+  }
+
+  void Print() const {
+    for (const auto& [request, count] : counts_) {
+      std::cout << std::left << std::setw(24) << ToString(request) << count << std::endl;
+    }
+  }
+
+ private:
+  // Events are written to a null stream unless verbose
+  std::ostream& Count(Request request, uint64_t host_id) {
+    counts_[request]++;
+    if (!verbose_) {
+      return null_stream_;
+    }
+    return std::cout << std::setw(10) << std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start_).count()
+                     << " ms " << std::hex << host_id << std::dec << " " << ToString(request);
+  }
+
+  bool verbose_;
+  Clock::time_point start_ = Clock::now();
+  std::map<Request, uint64_t> counts_;
+  std::ostream null_stream_{nullptr};
+};
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+  if (argc < 2 || (argc > 2 && std::string(argv[2]) != "original" && std::string(argv[2]) != "max")) {
+    std::cout << "Usage: " << argv[0] << " <capture file> [original | max (max)]" << std::endl;
+    return -1;
+  }
+  const bool original_speed = argc > 2 && std::string(argv[2]) == "original";
+
+  std::signal(SIGINT, SignalHandler);
+  std::signal(SIGTERM, SignalHandler);
+
+  auto receiver = std::make_unique<CaptureReceiver>(argv[1], original_speed);
+
+  if (!receiver->is_open()) {
+    return -1;
+  }
+  auto capture = receiver.get();
+  auto network = std::make_shared<LoopbackNetwork>(0, FaultSettings());
+  Recorder recorder(original_speed);
+  Clock::duration dispatch_time(0);
+  double elapsed = 0.0;
+  uint64_t datagrams = 0;
+  {
+    MultiPlayerController controller(&recorder, std::make_unique<LoopbackTransmitter>(network, "combatris_replay"),
+                                     std::move(receiver));
+    const auto start = Clock::now();
+
+    while (!cancelled.load(std::memory_order_acquire)) {
+      // Read before dispatching, the responses of the last datagram are queued by the time the capture is finished
+      const auto finished = capture->finished();
+      const auto dispatch_start = Clock::now();
+
+      controller.Dispatch();
+      dispatch_time += Clock::now() - dispatch_start;
+      if (finished) {
+        break;
+      }
+      if (original_speed) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(kFrameInterval));
+      } else {
+        std::this_thread::yield();
+      }
+    }
+    elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    datagrams = capture->datagrams_replayed();
+  }
+  recorder.Print();
+  std::cout << std::fixed << std::setprecision(2) << datagrams << " datagrams, " << recorder.total() << " events in "
+            << elapsed << " s (" << datagrams / std::max(elapsed, 1e-6) << " datagrams/s), dispatch "
+            << std::chrono::duration<double, std::milli>(dispatch_time).count() << " ms" << std::endl;
+
+  return 0;
+}